@@ -1,17 +1,33 @@
-QT += quick
+QT += quick concurrent network
 
 SOURCES += \
+        asyncreply.cpp \
         catalog.cpp \
+        catalogquery.cpp \
+        catalogsnapshot.cpp \
+        conversationstore.cpp \
         datamanager.cpp \
         favorites.cpp \
+        journal.cpp \
         main.cpp \
         message.cpp \
+        messagelistmodel.cpp \
+        persistenceworker.cpp \
         profile.cpp \
         request.cpp \
+        requestlistmodel.cpp \
+        requestquery.cpp \
         review.cpp \
+        reviewlistmodel.cpp \
         service.cpp \
+        servicelistmodel.cpp \
+        storage.cpp \
         subscription.cpp \
-        user.cpp
+        textindex.cpp \
+        trigramindex.cpp \
+        user.cpp \
+        userdirectory.cpp \
+        userstore.cpp
 
 resources.files = main.qml
 resources.prefix = /ALDA_FINAL
@@ -29,13 +45,32 @@ else: unix:!android: target.path = /opt/$${TARGET}/bin
 !isEmpty(target.path): INSTALLS += target
 
 HEADERS += \
+    asyncreply.h \
     catalog.h \
+    catalogquery.h \
+    catalogsnapshot.h \
+    conversationstore.h \
     datamanager.h \
     favorites.h \
+    idindex.h \
+    journal.h \
     message.h \
+    messagelistmodel.h \
+    persistenceworker.h \
     profile.h \
+    rankindex.h \
+    ratingaggregate.h \
     request.h \
+    requestlistmodel.h \
+    requestquery.h \
     review.h \
+    reviewlistmodel.h \
     service.h \
+    servicelistmodel.h \
+    storage.h \
     subscription.h \
-    user.h
+    textindex.h \
+    trigramindex.h \
+    user.h \
+    userdirectory.h \
+    userstore.h
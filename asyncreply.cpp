@@ -0,0 +1,37 @@
+#include "asyncreply.h"
+
+#include <QFutureWatcher>
+
+AsyncReply::AsyncReply(QObject* parent)
+    : QObject(parent)
+{
+}
+
+void AsyncReply::watch(const QFuture<QVariant>& future)
+{
+    m_watcher = new QFutureWatcher<QVariant>(this);
+    connect(m_watcher, &QFutureWatcherBase::finished, this, &AsyncReply::onFutureFinished);
+    m_watcher->setFuture(future);
+}
+
+void AsyncReply::complete(const QVariant& result)
+{
+    m_result = result;
+    // даже готовый результат отдаём через очередь: QML ещё не успел подключиться
+    QMetaObject::invokeMethod(this, &AsyncReply::deliver, Qt::QueuedConnection);
+}
+
+void AsyncReply::onFutureFinished()
+{
+    m_result = m_watcher->result();
+    deliver();
+}
+
+void AsyncReply::deliver()
+{
+    if (m_delivered) return;
+    m_delivered = true;
+
+    emit finished(m_result);
+    deleteLater();
+}
@@ -0,0 +1,40 @@
+#ifndef ASYNCREPLY_H
+#define ASYNCREPLY_H
+
+#include <QObject>
+#include <QVariant>
+#include <QFuture>
+
+template <typename T> class QFutureWatcher;
+
+// Ответ асинхронного вызова DataManager для QML (аналог promise):
+//   var reply = dataManager.catalogQueryAsync(spec)
+//   reply.finished.connect(function(rows) { ... })
+// finished приходит всегда из цикла событий GUI-потока, поэтому подключиться
+// после вызова не поздно. После finished объект удаляет себя сам.
+class AsyncReply : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AsyncReply(QObject* parent = nullptr);
+
+    // результат задачи пула потоков
+    void watch(const QFuture<QVariant>& future);
+    // результат, посчитанный иначе (например, применён в GUI-потоке)
+    void complete(const QVariant& result);
+
+signals:
+    void finished(const QVariant& result);
+
+private slots:
+    void onFutureFinished();
+    void deliver();
+
+private:
+    QFutureWatcher<QVariant>* m_watcher = nullptr;
+    QVariant m_result;
+    bool m_delivered = false;
+};
+
+#endif // ASYNCREPLY_H
@@ -2,6 +2,8 @@
 
 #include <QJsonArray>
 #include <QDateTime>
+#include <algorithm>
+#include <limits>
 
 Catalog::Catalog()
 {
@@ -9,12 +11,67 @@ Catalog::Catalog()
                  << "Обучение" << "Консультирование" << "Программирование";
 }
 
+static QUuid serviceKey(const Service& s) { return s.getId(); }
+
 int Catalog::indexOf(const QUuid& id) const
 {
-    if (id.isNull()) return -1;
-    for (int i = 0; i < m_services.size(); ++i)
-        if (m_services[i].getId() == id) return i;
-    return -1;
+    return m_byId.slotOf(id);
+}
+
+void Catalog::rebuildIndexes()
+{
+    m_byId.rebuild(m_services, serviceKey);
+
+    m_wordIndex.clear();
+    m_titleTrigrams.clear();
+    m_descriptionTrigrams.clear();
+    m_byRating.clear();
+    m_byCreatedAt.clear();
+    m_byPrice.clear();
+    m_byCategory.clear();
+    for (const auto& s : m_services)
+        indexService(s);
+}
+
+static QString wordText(const Service& s) { return s.getTitle() + '\n' + s.getDescription(); }
+
+void Catalog::indexService(const Service& s)
+{
+    m_wordIndex.add(s.getId(), wordText(s));
+    m_titleTrigrams.add(s.getId(), s.getTitle());
+    m_descriptionTrigrams.add(s.getId(), s.getDescription());
+    m_byRating.insert(s.getRating(), s.getId());
+    m_byCreatedAt.insert(createdKey(s), s.getId());
+    m_byPrice.insert(s.getPrice(), s.getId());
+    m_byCategory[s.getCategory()].insert(s.getId());
+}
+
+void Catalog::unindexService(const Service& s)
+{
+    m_wordIndex.remove(s.getId(), wordText(s));
+    m_titleTrigrams.remove(s.getId(), s.getTitle());
+    m_descriptionTrigrams.remove(s.getId(), s.getDescription());
+    m_byRating.remove(s.getRating(), s.getId());
+    m_byCreatedAt.remove(createdKey(s), s.getId());
+    m_byPrice.remove(s.getPrice(), s.getId());
+
+    auto it = m_byCategory.find(s.getCategory());
+    if (it != m_byCategory.end()) {
+        it.value().remove(s.getId());
+        if (it.value().isEmpty()) m_byCategory.erase(it);
+    }
+}
+
+QVector<int> Catalog::sortedSlots(const QSet<QUuid>& ids) const
+{
+    QVector<int> rows;
+    rows.reserve(ids.size());
+    for (const auto& id : ids) {
+        const int idx = indexOf(id);
+        if (idx >= 0) rows.append(idx);
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
 }
 
 void Catalog::ensureCategory(const QString& category)
@@ -28,8 +85,13 @@ void Catalog::addService(const Service& service)
 {
     // если пришёл сервис с уже существующим id — заменяем
     const int idx = indexOf(service.getId());
-    if (idx >= 0) m_services[idx] = service;
-    else m_services.append(service);
+    if (idx >= 0) {
+        unindexService(m_services[idx]);
+        m_services[idx] = service;
+    } else {
+        m_byId.append(m_services, service, serviceKey);
+    }
+    indexService(service);
 
     ensureCategory(service.getCategory());
 }
@@ -38,7 +100,8 @@ bool Catalog::removeService(const QUuid& serviceId)
 {
     const int idx = indexOf(serviceId);
     if (idx < 0) return false;
-    m_services.removeAt(idx);
+    unindexService(m_services[idx]);
+    m_byId.removeAt(m_services, idx, serviceKey);
     return true;
 }
 
@@ -46,20 +109,61 @@ bool Catalog::updateService(const Service& service)
 {
     const int idx = indexOf(service.getId());
     if (idx < 0) return false;
+    unindexService(m_services[idx]);
     m_services[idx] = service;
+    indexService(service);
     ensureCategory(service.getCategory());
     return true;
 }
 
+bool Catalog::setServiceRating(const QUuid& serviceId, double rating)
+{
+    const int idx = indexOf(serviceId);
+    if (idx < 0) return false;
+
+    Service& s = m_services[idx];
+    m_byRating.remove(s.getRating(), serviceId);
+    s.setRating(rating);
+    m_byRating.insert(s.getRating(), serviceId);
+    return true;
+}
+
+const Service* Catalog::findService(const QUuid& id) const
+{
+    const int idx = indexOf(id);
+    return idx >= 0 ? &m_services[idx] : nullptr;
+}
+
+QVector<Service> Catalog::servicesFor(const QVector<QUuid>& ids) const
+{
+    QVector<Service> results;
+    results.reserve(ids.size());
+    for (const auto& id : ids) {
+        const int idx = indexOf(id);
+        if (idx >= 0) results.append(m_services[idx]);
+    }
+    return results;
+}
+
 QVector<Service> Catalog::searchByName(const QString& name) const
 {
     QVector<Service> results;
     const QString q = name.trimmed();
     if (q.isEmpty()) return results;
 
-    for (const auto& s : m_services)
-        if (s.getTitle().contains(q, Qt::CaseInsensitive))
-            results.append(s);
+    QSet<QUuid> ids;
+    if (!m_titleTrigrams.candidates(q, &ids)) {
+        // 1-2 символа: триграмм нет, остаётся полный проход
+        for (const auto& s : m_services)
+            if (s.getTitle().contains(q, Qt::CaseInsensitive))
+                results.append(s);
+        return results;
+    }
+
+    const QVector<int> rows = sortedSlots(ids);
+    for (int idx : rows)
+        if (m_services[idx].getTitle().contains(q, Qt::CaseInsensitive))
+            results.append(m_services[idx]);
 
     return results;
 }
@@ -70,10 +174,29 @@ QVector<Service> Catalog::searchByDescription(const QString& text) const
     const QString q = text.trimmed();
     if (q.isEmpty()) return results;
 
-    for (const auto& s : m_services)
-        if (s.getDescription().contains(q, Qt::CaseInsensitive))
-            results.append(s);
+    QSet<QUuid> ids;
+    if (!m_descriptionTrigrams.candidates(q, &ids)) {
+        for (const auto& s : m_services)
+            if (s.getDescription().contains(q, Qt::CaseInsensitive))
+                results.append(s);
+        return results;
+    }
+
+    const QVector<int> rows = sortedSlots(ids);
+    for (int idx : rows)
+        if (m_services[idx].getDescription().contains(q, Qt::CaseInsensitive))
+            results.append(m_services[idx]);
+
+    return results;
+}
 
+QVector<Service> Catalog::searchByWords(const QString& query) const
+{
+    QVector<Service> results;
+    const QVector<int> rows = sortedSlots(m_wordIndex.match(query));
+    results.reserve(rows.size());
+    for (int idx : rows)
+        results.append(m_services[idx]);
     return results;
 }
 
@@ -83,10 +206,230 @@ QVector<Service> Catalog::filterByCategory(const QString& category) const
     const QString c = category.trimmed();
     if (c.isEmpty()) return results;
 
-    for (const auto& s : m_services)
-        if (s.getCategory() == c)
-            results.append(s);
+    const auto it = m_byCategory.constFind(c);
+    if (it == m_byCategory.constEnd()) return results;
+
+    const QVector<int> rows = sortedSlots(it.value());
+    results.reserve(rows.size());
+    for (int idx : rows)
+        results.append(m_services[idx]);
+
+    return results;
+}
+
+// ---------------- Composite query ----------------
+// категория меньше этого размера проверяется построчно, без пересечения триграмм
+static const int kSmallCategory = 1024;
+// диапазон цены/рейтинга берётся источником, только если в нём меньше записей
+static const int kRangeCandidates = 4096;
+
+// больше любого id: верхняя граница для (key, id) в RankIndex
+static QUuid maxUuid()
+{
+    return QUuid(0xffffffff, 0xffff, 0xffff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff);
+}
+
+// id записей индекса с ключом в [lo, hi]; false (и пустой out) — их не меньше cap
+template <typename K>
+static bool collectRange(const RankIndex<K>& index, K lo, K hi, int cap, QSet<QUuid>* out)
+{
+    for (auto it = index.lowerBound(lo, QUuid()); it != index.end() && it.key().first <= hi; ++it) {
+        if (out->size() >= cap) {
+            out->clear();
+            return false;
+        }
+        out->insert(it.key().second);
+    }
+    return true;
+}
+
+// q уже нормализован (text/category обрезаны)
+static bool matchesQuery(const Service& s, const CatalogQuery& q)
+{
+    if (q.activeOnly && !s.isActive()) return false;
+    if (!q.category.isEmpty() && s.getCategory() != q.category) return false;
+
+    const double p = s.getPrice();
+    if (p < q.minPrice || p > q.maxPrice) return false;
+    if (s.getRating() < q.minRating) return false;
+
+    if (!q.text.isEmpty() && !s.getTitle().contains(q.text, Qt::CaseInsensitive)) return false;
+    return true;
+}
+
+// порядок совпадает с обходом RankIndex: при равных ключах решает id
+struct RankedSlot
+{
+    double key;
+    QUuid id;
+    int slot;
+};
+
+static bool rankedAsc(const RankedSlot& a, const RankedSlot& b)
+{
+    if (a.key != b.key) return a.key < b.key;
+    return a.id < b.id;
+}
+
+static bool rankedDesc(const RankedSlot& a, const RankedSlot& b)
+{
+    return rankedAsc(b, a);
+}
+
+double Catalog::sortKey(const Service& s, CatalogQuery::Sort sort)
+{
+    switch (sort) {
+    case CatalogQuery::SortRating:    return s.getRating();
+    case CatalogQuery::SortNewest:    return double(createdKey(s));
+    case CatalogQuery::SortPriceAsc:
+    case CatalogQuery::SortPriceDesc: return s.getPrice();
+    default:                          return 0.0;
+    }
+}
+
+bool Catalog::matches(const Service& s, const CatalogQuery& spec)
+{
+    CatalogQuery q = spec;
+    q.text = q.text.trimmed();
+    q.category = q.category.trimmed();
+    return matchesQuery(s, q);
+}
+
+// старт — ближайшая к началу обхода из двух позиций: граница диапазона или курсор
+template <typename K>
+QVector<int> Catalog::walkRank(const RankIndex<K>& index, bool descending, K lo, K hi,
+                               const QSet<QUuid>* probe, const CatalogQuery& q, int limit) const
+{
+    QVector<int> rows;
+    const QPair<K, QUuid> cursor(K(q.afterKey), q.afterId);
+    if (descending) {
+        auto it = (q.hasAfter && cursor <= qMakePair(hi, maxUuid()))
+                ? index.lowerBound(cursor.first, cursor.second) : index.upperBound(hi, maxUuid());
+        while (it != index.begin() && (limit < 0 || rows.size() < limit)) {
+            --it;
+            if (it.key().first < lo) break;
+            if (probe && !probe->contains(it.key().second)) continue;
+            const int idx = indexOf(it.key().second);
+            if (idx >= 0 && matchesQuery(m_services[idx], q)) rows.append(idx);
+        }
+    } else {
+        auto it = (q.hasAfter && qMakePair(lo, QUuid()) <= cursor)
+                ? index.upperBound(cursor.first, cursor.second) : index.lowerBound(lo, QUuid());
+        for (; it != index.end() && (limit < 0 || rows.size() < limit); ++it) {
+            if (it.key().first > hi) break;
+            if (probe && !probe->contains(it.key().second)) continue;
+            const int idx = indexOf(it.key().second);
+            if (idx >= 0 && matchesQuery(m_services[idx], q)) rows.append(idx);
+        }
+    }
+    return rows;
+}
 
+QVector<Service> Catalog::query(const CatalogQuery& spec) const
+{
+    QVector<Service> results;
+
+    CatalogQuery q = spec;
+    q.text = q.text.trimmed();
+    q.category = q.category.trimmed();
+    if (q.limit == 0 || q.minPrice > q.maxPrice) return results;
+
+    // 1) планировщик: самый узкий источник кандидатов
+    const QSet<QUuid>* driver = nullptr;
+    if (!q.category.isEmpty()) {
+        const auto it = m_byCategory.constFind(q.category);
+        if (it == m_byCategory.constEnd()) return results;
+        driver = &it.value();
+    }
+
+    QSet<QUuid> textIds;
+    if (!q.text.isEmpty() && (!driver || driver->size() >= kSmallCategory)
+        && m_titleTrigrams.candidates(q.text, &textIds)) {
+        if (!driver || textIds.size() < driver->size()) driver = &textIds;
+    }
+
+    // диапазоны цены и рейтинга: отрезок упорядоченного индекса, если он уже текущего
+    // источника. По столбцу сортировки диапазон вместо этого ограничивает её обход
+    const double noMin = -std::numeric_limits<double>::max();
+    const double noMax = std::numeric_limits<double>::max();
+    const bool sortByPrice = (q.sort == CatalogQuery::SortPriceAsc || q.sort == CatalogQuery::SortPriceDesc);
+
+    QSet<QUuid> priceIds;
+    if ((q.minPrice > noMin || q.maxPrice < noMax) && !sortByPrice
+        && collectRange(m_byPrice, q.minPrice, q.maxPrice, driver ? int(driver->size()) : kRangeCandidates, &priceIds))
+        driver = &priceIds;
+
+    QSet<QUuid> ratingIds;
+    if (q.minRating > noMin && q.sort != CatalogQuery::SortRating
+        && collectRange(m_byRating, q.minRating, noMax, driver ? int(driver->size()) : kRangeCandidates, &ratingIds))
+        driver = &ratingIds;
+
+    QVector<int> rows;
+    bool ordered = false;
+
+    // большой источник при сортировке не собирается целиком на каждой странице:
+    // индекс сортировки обходится с курсора с проверкой принадлежности источнику
+    const bool probeWalk = driver && q.sort != CatalogQuery::SortNone && driver->size() >= kSmallCategory;
+
+    if (driver && !probeWalk) {
+        const QVector<int> candidates = sortedSlots(*driver);
+        for (int idx : candidates)
+            if (matchesQuery(m_services[idx], q)) rows.append(idx);
+    } else {
+        // идём по индексу сортировки и останавливаемся на limit
+        switch (q.sort) {
+        case CatalogQuery::SortRating:
+            rows = walkRank(m_byRating, true, q.minRating, noMax, driver, q, q.limit);
+            ordered = true;
+            break;
+        case CatalogQuery::SortNewest:
+            rows = walkRank(m_byCreatedAt, true, std::numeric_limits<qint64>::min(),
+                            std::numeric_limits<qint64>::max(), driver, q, q.limit);
+            ordered = true;
+            break;
+        case CatalogQuery::SortPriceAsc:
+            rows = walkRank(m_byPrice, false, q.minPrice, q.maxPrice, driver, q, q.limit);
+            ordered = true;
+            break;
+        case CatalogQuery::SortPriceDesc:
+            rows = walkRank(m_byPrice, true, q.minPrice, q.maxPrice, driver, q, q.limit);
+            ordered = true;
+            break;
+        default:
+            for (int i = 0; i < m_services.size() && (q.limit < 0 || rows.size() < q.limit); ++i)
+                if (matchesQuery(m_services[i], q)) rows.append(i);
+            ordered = true;
+            break;
+        }
+    }
+
+    // 2) сортировка кандидатов (частичная, если есть limit)
+    if (!ordered && q.sort != CatalogQuery::SortNone) {
+        const bool asc = (q.sort == CatalogQuery::SortPriceAsc);
+        const RankedSlot cursor = { q.afterKey, q.afterId, -1 };
+
+        QVector<RankedSlot> ranked;
+        ranked.reserve(rows.size());
+        for (int idx : rows) {
+            RankedSlot r = { sortKey(m_services[idx], q.sort), m_services[idx].getId(), idx };
+            if (q.hasAfter && !(asc ? rankedAsc(cursor, r) : rankedDesc(cursor, r))) continue;
+            ranked.append(r);
+        }
+
+        const int n = (q.limit >= 0 && q.limit < ranked.size()) ? q.limit : int(ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + n, ranked.end(), asc ? rankedAsc : rankedDesc);
+
+        rows.resize(n);
+        for (int i = 0; i < n; ++i)
+            rows[i] = ranked[i].slot;
+    }
+
+    // 3) материализуем только итоговую страницу
+    if (q.limit >= 0 && rows.size() > q.limit) rows.resize(q.limit);
+
+    results.reserve(rows.size());
+    for (int idx : rows)
+        results.append(m_services[idx]);
     return results;
 }
 
@@ -95,20 +438,30 @@ QVector<Service> Catalog::filterByPrice(double minPrice, double maxPrice) const
     QVector<Service> results;
     if (minPrice > maxPrice) return results;
 
-    for (const auto& s : m_services) {
-        const double p = s.getPrice();
-        if (p >= minPrice && p <= maxPrice)
-            results.append(s);
-    }
+    // отрезок индекса цены; порядок результата — порядок хранения, как раньше
+    QSet<QUuid> ids;
+    for (auto it = m_byPrice.lowerBound(minPrice, QUuid()); it != m_byPrice.end() && it.key().first <= maxPrice; ++it)
+        ids.insert(it.key().second);
+
+    const QVector<int> rows = sortedSlots(ids);
+    results.reserve(rows.size());
+    for (int idx : rows)
+        results.append(m_services[idx]);
     return results;
 }
 
 QVector<Service> Catalog::filterByRating(double minRating) const
 {
+    // хвост индекса рейтинга от minRating; порядок результата — порядок хранения, как раньше
+    QSet<QUuid> ids;
+    for (auto it = m_byRating.lowerBound(minRating, QUuid()); it != m_byRating.end(); ++it)
+        ids.insert(it.key().second);
+
     QVector<Service> results;
-    for (const auto& s : m_services)
-        if (s.getRating() >= minRating)
-            results.append(s);
+    const QVector<int> rows = sortedSlots(ids);
+    results.reserve(rows.size());
+    for (int idx : rows)
+        results.append(m_services[idx]);
     return results;
 }
 
@@ -121,44 +474,14 @@ QVector<Service> Catalog::getActiveServices() const
     return results;
 }
 
-// пузырёк по рейтингу (без lambda, как у тебя) [file:55]
 QVector<Service> Catalog::getPopularServices(int count) const
 {
-    QVector<Service> sorted = m_services;
-
-    for (int i = 0; i < sorted.size() - 1; ++i) {
-        for (int j = i + 1; j < sorted.size(); ++j) {
-            if (sorted[i].getRating() < sorted[j].getRating()) {
-                Service tmp = sorted[i];
-                sorted[i] = sorted[j];
-                sorted[j] = tmp;
-            }
-        }
-    }
-
-    if (count < 0) count = 0;
-    if (sorted.size() > count) sorted = sorted.mid(0, count);
-    return sorted;
+    return servicesFor(m_byRating.top(count));
 }
 
-// пузырёк по дате (без lambda, как у тебя) [file:55]
 QVector<Service> Catalog::getNewServices(int count) const
 {
-    QVector<Service> sorted = m_services;
-
-    for (int i = 0; i < sorted.size() - 1; ++i) {
-        for (int j = i + 1; j < sorted.size(); ++j) {
-            if (sorted[i].getCreatedAt() < sorted[j].getCreatedAt()) {
-                Service tmp = sorted[i];
-                sorted[i] = sorted[j];
-                sorted[j] = tmp;
-            }
-        }
-    }
-
-    if (count < 0) count = 0;
-    if (sorted.size() > count) sorted = sorted.mid(0, count);
-    return sorted;
+    return servicesFor(m_byCreatedAt.top(count));
 }
 
 void Catalog::addSearchHistory(const QString& query)
@@ -230,5 +553,6 @@ Catalog Catalog::fromJson(const QJsonObject& json)
     for (int i = 0; i < servicesArray.size(); ++i)
         catalog.m_services.append(Service::fromJson(servicesArray[i].toObject())); // [file:37]
 
+    catalog.rebuildIndexes();
     return catalog;
 }
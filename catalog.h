@@ -2,12 +2,19 @@
 #define CATALOG_H
 
 #include <QVector>
+#include <QHash>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QJsonObject>
 #include <QUuid>
 
 #include "service.h" // Service хранится по значению -> нужен полный тип [file:36]
+#include "catalogquery.h"
+#include "idindex.h"
+#include "rankindex.h"
+#include "textindex.h"
+#include "trigramindex.h"
 
 class Catalog
 {
@@ -18,10 +25,21 @@ public:
     void addService(const Service& service);
     bool removeService(const QUuid& serviceId);
     bool updateService(const Service& service); // удобно, чтобы не делать remove+add снаружи
+    bool setServiceRating(const QUuid& serviceId, double rating); // трогает только индекс рейтинга
 
-    // Search operations
+    // Search operations: подстрока без учёта регистра (кандидаты из индекса триграмм)
     QVector<Service> searchByName(const QString& name) const;
     QVector<Service> searchByDescription(const QString& text) const;
+    // по словам в названии или описании, несколько слов — AND (регистр и ё/е не важны)
+    QVector<Service> searchByWords(const QString& query) const;
+
+    // Составной запрос: сначала самый селективный индекс, Service копируются только для итоговой страницы
+    QVector<Service> query(const CatalogQuery& spec) const;
+    static double sortKey(const Service& s, CatalogQuery::Sort sort); // ключ для курсора
+    static bool matches(const Service& s, const CatalogQuery& spec);
+
+    // O(1) по id; указатель действителен до следующего изменения каталога
+    const Service* findService(const QUuid& id) const;
 
     // Filter operations
     QVector<Service> filterByCategory(const QString& category) const;
@@ -29,11 +47,12 @@ public:
     QVector<Service> filterByRating(double minRating) const;
     QVector<Service> getActiveServices() const;
 
-    // Get special lists
+    // Get special lists: top-K из упорядоченных индексов, O(K)
     QVector<Service> getPopularServices(int count = 10) const;
     QVector<Service> getNewServices(int count = 10) const;
 
     QVector<Service> getAllServices() const { return m_services; }
+    int serviceCount() const { return int(m_services.size()); }
     QStringList getCategories() const { return m_categories; }
     QStringList getSearchHistory() const { return m_searchHistory; }
 
@@ -49,11 +68,30 @@ public:
     static Catalog fromJson(const QJsonObject& json);
 
 private:
+    friend class CatalogSnapshot; // бинарный снапшот собирает каталог напрямую
+
     int indexOf(const QUuid& id) const;
     void ensureCategory(const QString& category);
+    void rebuildIndexes(); // после массовой загрузки (fromJson, снапшот)
+    void indexService(const Service& s);   // вторичные индексы (текст, рейтинг, дата)
+    void unindexService(const Service& s);
+    QVector<Service> servicesFor(const QVector<QUuid>& ids) const;
+    // обход индекса в пределах ключей [lo, hi] с курсора q; probe — только эти id
+    template <typename K>
+    QVector<int> walkRank(const RankIndex<K>& index, bool descending, K lo, K hi,
+                          const QSet<QUuid>* probe, const CatalogQuery& q, int limit) const;
+    QVector<int> sortedSlots(const QSet<QUuid>& ids) const; // порядок хранения
 
 private:
     QVector<Service> m_services;
+    IdIndex m_byId;
+    TextIndex m_wordIndex;
+    TrigramIndex m_titleTrigrams;
+    TrigramIndex m_descriptionTrigrams;
+    RankIndex<double> m_byRating;
+    RankIndex<qint64> m_byCreatedAt;
+    RankIndex<double> m_byPrice;
+    QHash<QString, QSet<QUuid>> m_byCategory;
     QStringList m_categories;
     QStringList m_searchHistory;
 };
@@ -0,0 +1,21 @@
+#include "catalogquery.h"
+
+CatalogQuery CatalogQuery::fromVariantMap(const QVariantMap& m)
+{
+    CatalogQuery q;
+    q.text = m.value("text").toString();
+    q.category = m.value("category").toString();
+    if (m.contains("minPrice")) q.minPrice = m.value("minPrice").toDouble();
+    if (m.contains("maxPrice")) q.maxPrice = m.value("maxPrice").toDouble();
+    if (m.contains("minRating")) q.minRating = m.value("minRating").toDouble();
+    q.activeOnly = m.value("activeOnly").toBool();
+    q.limit = m.value("limit", -1).toInt();
+
+    const QString sort = m.value("sort").toString();
+    if (sort == "rating") q.sort = CatalogQuery::SortRating;
+    else if (sort == "newest") q.sort = CatalogQuery::SortNewest;
+    else if (sort == "priceAsc") q.sort = CatalogQuery::SortPriceAsc;
+    else if (sort == "priceDesc") q.sort = CatalogQuery::SortPriceDesc;
+
+    return q;
+}
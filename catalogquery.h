@@ -0,0 +1,42 @@
+#ifndef CATALOGQUERY_H
+#define CATALOGQUERY_H
+
+#include <QString>
+#include <QUuid>
+#include <QVariantMap>
+#include <limits>
+
+// Составной запрос к каталогу: все условия через AND + сортировка и лимит.
+// Пустые строки и значения по умолчанию означают "без условия".
+struct CatalogQuery
+{
+    enum Sort {
+        SortNone,       // порядок хранения
+        SortRating,     // по убыванию рейтинга
+        SortNewest,     // по убыванию createdAt
+        SortPriceAsc,
+        SortPriceDesc
+    };
+
+    QString text;       // подстрока в названии, как searchByName
+    QString category;   // точное совпадение, как filterByCategory
+    double minPrice = -std::numeric_limits<double>::max();
+    double maxPrice = std::numeric_limits<double>::max();
+    double minRating = -std::numeric_limits<double>::max();
+    bool activeOnly = false;
+
+    Sort sort = SortNone;
+    int limit = -1;     // < 0 — без ограничения
+
+    // keyset-курсор: только строки строго после (afterKey, afterId) в порядке sort.
+    // afterKey = Catalog::sortKey последней строки прошлой страницы; для SortNone не действует
+    bool hasAfter = false;
+    double afterKey = 0.0;
+    QUuid afterId;
+
+    // из QML: {text, category, minPrice, maxPrice, minRating, activeOnly,
+    //          sort: "rating"|"newest"|"priceAsc"|"priceDesc", limit}
+    static CatalogQuery fromVariantMap(const QVariantMap& m);
+};
+
+#endif // CATALOGQUERY_H
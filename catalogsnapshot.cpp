@@ -0,0 +1,272 @@
+#include "catalogsnapshot.h"
+#include "catalog.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QHash>
+#include <QVector>
+#include <QSysInfo>
+#include <QtEndian>
+
+#include <cstring>
+
+static const char kMagic[4] = { 'A', 'L', 'D', 'C' };
+static const qint64 kHeaderSize = 32;
+static const qint64 kRecordSize = 80;
+
+static const quint32 kFlagActive       = 0x1;
+static const quint32 kFlagHasCreatedAt = 0x2;
+
+// ---------------- little-endian helpers ----------------
+static void putU32(QByteArray& b, quint32 v)
+{
+    uchar buf[4];
+    qToLittleEndian(v, buf);
+    b.append(reinterpret_cast<const char*>(buf), 4);
+}
+
+static void putU64(QByteArray& b, quint64 v)
+{
+    uchar buf[8];
+    qToLittleEndian(v, buf);
+    b.append(reinterpret_cast<const char*>(buf), 8);
+}
+
+static void putF64(QByteArray& b, double v)
+{
+    quint64 bits = 0;
+    std::memcpy(&bits, &v, sizeof bits);
+    putU64(b, bits);
+}
+
+static quint32 getU32(const uchar* p) { return qFromLittleEndian<quint32>(p); }
+static quint64 getU64(const uchar* p) { return qFromLittleEndian<quint64>(p); }
+
+static double getF64(const uchar* p)
+{
+    const quint64 bits = getU64(p);
+    double v = 0.0;
+    std::memcpy(&v, &bits, sizeof v);
+    return v;
+}
+
+// таблица строк с дедупликацией (категории и пути медиа повторяются)
+struct StringTableBuilder
+{
+    QHash<QString, quint32> ids;
+    QVector<QString> strings;
+
+    quint32 add(const QString& s)
+    {
+        const auto it = ids.constFind(s);
+        if (it != ids.constEnd()) return it.value();
+
+        const quint32 id = quint32(strings.size());
+        ids.insert(s, id);
+        strings.append(s);
+        return id;
+    }
+};
+
+// ---------------- write ----------------
+CatalogData CatalogSnapshot::dataOf(const Catalog& catalog)
+{
+    CatalogData data;
+    data.services = catalog.m_services;
+    data.categories = catalog.m_categories;
+    data.searchHistory = catalog.m_searchHistory;
+    return data;
+}
+
+bool CatalogSnapshot::write(const CatalogData& catalog, const QString& path)
+{
+    // строки пишутся как есть (UTF-16 хоста), поэтому формат только для LE
+    if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) return false;
+
+    const QVector<Service>& services = catalog.services;
+
+    StringTableBuilder strings;
+    QVector<quint32> mediaRefs;
+
+    QByteArray records;
+    records.reserve(int(services.size() * kRecordSize));
+
+    for (const auto& s : services) {
+        const QDateTime createdAt = s.getCreatedAt();
+        const QStringList media = s.getMedia();
+
+        quint32 flags = 0;
+        if (s.isActive()) flags |= kFlagActive;
+        if (createdAt.isValid()) flags |= kFlagHasCreatedAt;
+
+        records.append(s.getId().toRfc4122());
+        records.append(s.getProviderId().toRfc4122());
+        putU64(records, quint64(createdAt.isValid() ? createdAt.toMSecsSinceEpoch() : 0));
+        putF64(records, s.getPrice());
+        putF64(records, s.getRating());
+        putU32(records, strings.add(s.getTitle()));
+        putU32(records, strings.add(s.getDescription()));
+        putU32(records, strings.add(s.getCategory()));
+        putU32(records, quint32(mediaRefs.size()));
+        putU32(records, quint32(media.size()));
+        putU32(records, flags);
+
+        for (const auto& m : media)
+            mediaRefs.append(strings.add(m));
+    }
+
+    QVector<quint32> categoryRefs;
+    for (const auto& c : catalog.categories)
+        categoryRefs.append(strings.add(c));
+
+    QVector<quint32> historyRefs;
+    for (const auto& h : catalog.searchHistory)
+        historyRefs.append(strings.add(h));
+
+    QByteArray out;
+    out.append(kMagic, 4);
+    putU32(out, Version);
+    putU32(out, quint32(services.size()));
+    putU32(out, quint32(mediaRefs.size()));
+    putU32(out, quint32(categoryRefs.size()));
+    putU32(out, quint32(historyRefs.size()));
+    putU32(out, quint32(strings.strings.size()));
+    putU32(out, 0); // reserved
+
+    out.append(records);
+    for (quint32 r : mediaRefs) putU32(out, r);
+    for (quint32 r : categoryRefs) putU32(out, r);
+    for (quint32 r : historyRefs) putU32(out, r);
+
+    quint32 offset = 0;
+    for (const auto& str : strings.strings) {
+        putU32(out, offset);
+        putU32(out, quint32(str.size()));
+        offset += quint32(str.size());
+    }
+    for (const auto& str : strings.strings)
+        out.append(reinterpret_cast<const char*>(str.utf16()), int(str.size() * 2));
+
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    if (f.write(out) != out.size()) {
+        f.cancelWriting();
+        return false;
+    }
+    return f.commit();
+}
+
+// ---------------- read ----------------
+bool CatalogSnapshot::read(const QString& path, Catalog* out)
+{
+    if (!out) return false;
+    if (QSysInfo::ByteOrder != QSysInfo::LittleEndian) return false;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return false;
+
+    const qint64 size = f.size();
+    if (size < kHeaderSize) return false;
+
+    uchar* data = f.map(0, size);
+    if (!data) return false;
+
+    const bool ok = decode(data, size, out);
+    f.unmap(data);
+    return ok;
+}
+
+bool CatalogSnapshot::decode(const uchar* data, qint64 size, Catalog* out)
+{
+    if (std::memcmp(data, kMagic, 4) != 0) return false;
+    if (getU32(data + 4) != Version) return false;
+
+    const quint32 serviceCount  = getU32(data + 8);
+    const quint32 mediaRefCount = getU32(data + 12);
+    const quint32 categoryCount = getU32(data + 16);
+    const quint32 historyCount  = getU32(data + 20);
+    const quint32 stringCount   = getU32(data + 24);
+
+    // границы секций считаем в qint64, чтобы битый заголовок не переполнил смещения
+    const qint64 recordsOff    = kHeaderSize;
+    const qint64 mediaOff      = recordsOff + qint64(serviceCount) * kRecordSize;
+    const qint64 categoriesOff = mediaOff + qint64(mediaRefCount) * 4;
+    const qint64 historyOff    = categoriesOff + qint64(categoryCount) * 4;
+    const qint64 indexOff      = historyOff + qint64(historyCount) * 4;
+    const qint64 stringDataOff = indexOff + qint64(stringCount) * 8;
+    if (stringDataOff > size) return false;
+
+    const qint64 stringUnits = (size - stringDataOff) / 2;
+    const QChar* chars = reinterpret_cast<const QChar*>(data + stringDataOff);
+
+    // каждая строка декодируется один раз, сервисы делят её через implicit sharing
+    QVector<QString> strings;
+    strings.reserve(int(stringCount));
+    for (quint32 i = 0; i < stringCount; ++i) {
+        const uchar* e = data + indexOff + qint64(i) * 8;
+        const quint32 off = getU32(e);
+        const quint32 len = getU32(e + 4);
+        if (qint64(off) + qint64(len) > stringUnits) return false;
+        strings.append(QString(chars + off, int(len)));
+    }
+
+    const quint32 nStrings = quint32(strings.size());
+
+    Catalog catalog;
+    catalog.m_services.reserve(int(serviceCount));
+
+    for (quint32 i = 0; i < serviceCount; ++i) {
+        const uchar* r = data + recordsOff + qint64(i) * kRecordSize;
+
+        const quint32 title       = getU32(r + 56);
+        const quint32 description = getU32(r + 60);
+        const quint32 category    = getU32(r + 64);
+        const quint32 mediaFirst  = getU32(r + 68);
+        const quint32 mediaCount  = getU32(r + 72);
+        const quint32 flags       = getU32(r + 76);
+
+        if (title >= nStrings || description >= nStrings || category >= nStrings) return false;
+        if (qint64(mediaFirst) + qint64(mediaCount) > qint64(mediaRefCount)) return false;
+
+        QStringList media;
+        for (quint32 k = 0; k < mediaCount; ++k) {
+            const quint32 ref = getU32(data + mediaOff + qint64(mediaFirst + k) * 4);
+            if (ref >= nStrings) return false;
+            media.append(strings[int(ref)]);
+        }
+
+        const QDateTime createdAt = (flags & kFlagHasCreatedAt)
+                                        ? QDateTime::fromMSecsSinceEpoch(qint64(getU64(r + 32)))
+                                        : QDateTime();
+
+        catalog.m_services.append(Service(
+            QUuid::fromRfc4122(QByteArray::fromRawData(reinterpret_cast<const char*>(r), 16)),
+            QUuid::fromRfc4122(QByteArray::fromRawData(reinterpret_cast<const char*>(r + 16), 16)),
+            strings[int(title)],
+            strings[int(description)],
+            strings[int(category)],
+            getF64(r + 40),
+            (flags & kFlagActive) != 0,
+            getF64(r + 48),
+            createdAt,
+            media));
+    }
+
+    catalog.m_categories.clear();
+    for (quint32 i = 0; i < categoryCount; ++i) {
+        const quint32 ref = getU32(data + categoriesOff + qint64(i) * 4);
+        if (ref >= nStrings) return false;
+        catalog.m_categories.append(strings[int(ref)]);
+    }
+
+    catalog.m_searchHistory.clear();
+    for (quint32 i = 0; i < historyCount; ++i) {
+        const quint32 ref = getU32(data + historyOff + qint64(i) * 4);
+        if (ref >= nStrings) return false;
+        catalog.m_searchHistory.append(strings[int(ref)]);
+    }
+
+    catalog.rebuildIndexes();
+    *out = catalog;
+    return true;
+}
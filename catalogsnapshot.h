@@ -0,0 +1,51 @@
+#ifndef CATALOGSNAPSHOT_H
+#define CATALOGSNAPSHOT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "service.h"
+
+class Catalog;
+
+// То, что пишется в снапшот, — без производных индексов каталога.
+// Воркер держит только это, поэтому следующая мутация каталога не копирует индексы
+struct CatalogData
+{
+    QVector<Service> services;
+    QStringList categories;
+    QStringList searchHistory;
+};
+
+// Бинарный снапшот каталога (services.bin), читается через QFile::map.
+//
+// Формат v1, little-endian:
+//   Header        magic "ALDC", u32 version, u32 serviceCount, u32 mediaRefCount,
+//                 u32 categoryCount, u32 historyCount, u32 stringCount, u32 reserved
+//   Records       serviceCount x 80 байт:
+//                 id[16] (RFC 4122), providerId[16], i64 createdAt (ms epoch),
+//                 f64 price, f64 rating, u32 title, u32 description, u32 category,
+//                 u32 mediaFirst, u32 mediaCount, u32 flags (bit0 = active)
+//   MediaRefs     mediaRefCount x u32   (индексы строк)
+//   Categories    categoryCount x u32
+//   History       historyCount x u32
+//   StringIndex   stringCount x { u32 offset; u32 length }  (в UTF-16 единицах)
+//   StringData    UTF-16LE, без разделителей
+//
+// Одинаковые строки (категории, пути медиа) хранятся один раз.
+// JSON (Catalog::toJson/fromJson) остаётся форматом импорта/экспорта.
+class CatalogSnapshot
+{
+public:
+    static const quint32 Version = 1;
+
+    static CatalogData dataOf(const Catalog& catalog);
+    static bool write(const CatalogData& catalog, const QString& path);
+    static bool read(const QString& path, Catalog* out);
+
+private:
+    static bool decode(const uchar* data, qint64 size, Catalog* out);
+};
+
+#endif // CATALOGSNAPSHOT_H
@@ -0,0 +1,366 @@
+#include "conversationstore.h"
+#include "journal.h"
+
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+QString ConversationStore::filePath(const QString& dir, const QUuid& conversationId)
+{
+    return dir + '/' + conversationId.toString(QUuid::WithoutBraces) + ".journal";
+}
+
+int ConversationStore::messageCount(const QUuid& id) const
+{
+    const auto it = m_conversations.constFind(id);
+    return it == m_conversations.constEnd() ? 0 : it.value().count;
+}
+
+const Message* ConversationStore::lastMessage(const QUuid& id) const
+{
+    const auto it = m_conversations.constFind(id);
+    if (it == m_conversations.constEnd() || it.value().count == 0) return nullptr;
+    return &it.value().last;
+}
+
+void ConversationStore::ensure(const QUuid& id, const QVector<QUuid>& participants)
+{
+    if (id.isNull()) return;
+
+    Conversation& c = m_conversations[id];
+    c.id = id;
+    for (const auto& p : participants) {
+        if (!p.isNull() && !c.participants.contains(p))
+            c.participants.append(p);
+    }
+}
+
+// та же кодировка, что у Journal::append: компактный JSON + '\n'
+qint64 ConversationStore::recordSize(const QJsonObject& record)
+{
+    return QJsonDocument(record).toJson(QJsonDocument::Compact).size() + 1;
+}
+
+ConversationStore::Conversation& ConversationStore::countMessage(const QUuid& id, const QUuid& senderId,
+                                                                 qint64 size, bool countUnread)
+{
+    Conversation& c = m_conversations[id];
+    c.id = id;
+    c.bytes += size;
+    ++c.count;
+
+    for (const auto& p : c.participants) {
+        if (countUnread && p != senderId) ++c.unread[p];
+    }
+    return c;
+}
+
+QJsonObject ConversationStore::append(const QUuid& id, const Message& m, bool countUnread)
+{
+    const QJsonObject record = m.toJson();
+
+    const auto it = m_conversations.constFind(id);
+    const qint64 offset = it == m_conversations.constEnd() ? 0 : it.value().bytes;
+    Conversation& c = countMessage(id, m.getSenderId(), recordSize(record), countUnread);
+    c.last = m;
+    c.lastStale = false;
+
+    if (c.tailLoaded) {
+        Entry e;
+        e.message = m;
+        e.offset = offset;
+        c.tail.append(e);
+
+        // вытесненные из хвоста остаются доступны как курсор beforeId
+        const int excess = int(c.tail.size()) - kTailSize;
+        for (int i = 0; i < excess; ++i)
+            c.offsets.insert(c.tail[i].message.getId(), c.tail[i].offset);
+        if (excess > 0) c.tail.remove(0, excess);
+    }
+    return record;
+}
+
+// ---------------- unread ----------------
+int ConversationStore::unread(const QUuid& id, const QUuid& userId) const
+{
+    const auto it = m_conversations.constFind(id);
+    return it == m_conversations.constEnd() ? 0 : it.value().unread.value(userId, 0);
+}
+
+bool ConversationStore::markRead(const QUuid& id, const QUuid& userId)
+{
+    const auto it = m_conversations.find(id);
+    if (it == m_conversations.end() || it.value().unread.value(userId, 0) == 0) return false;
+
+    it.value().unread.remove(userId);
+    return true;
+}
+
+// ---------------- pages ----------------
+void ConversationStore::loadTail(Conversation& c) const
+{
+    const QString path = filePath(c.id);
+    const qint64 size = QFileInfo(path).size();
+
+    c.tail.clear();
+    const QVector<Journal::Record> records = Journal::readRecordsBefore(path, size, kTailSize);
+    c.tail.reserve(records.size());
+    for (const auto& r : records) {
+        Entry e;
+        e.message = Message::fromJson(r.object);
+        e.offset = r.offset;
+        c.tail.append(e);
+    }
+
+    // после сбоя метаданные могут отставать от файла; дописывать дальше — по реальной длине
+    c.bytes = size;
+    if (c.count < c.tail.size()) c.count = int(c.tail.size());
+    if (!c.tail.isEmpty()) {
+        c.last = c.tail.last().message;
+        c.lastStale = false;
+    }
+    c.tailLoaded = true;
+}
+
+int ConversationStore::tailCursor(const Conversation& c, const QUuid& beforeId)
+{
+    if (beforeId.isNull()) return int(c.tail.size());
+    for (int i = int(c.tail.size()) - 1; i >= 0; --i) {
+        if (c.tail[i].message.getId() == beforeId) return i;
+    }
+    return -1;
+}
+
+qint64 ConversationStore::offsetOf(Conversation& c, const QUuid& messageId) const
+{
+    const auto it = c.offsets.constFind(messageId);
+    if (it != c.offsets.constEnd()) return it.value();
+
+    // курсор не из этой сессии: один проход по файлу, смещения запоминаются
+    const QVector<Journal::Record> records = Journal::readRecordsWithOffsets(filePath(c.id));
+    for (const auto& r : records)
+        c.offsets.insert(QUuid(r.object.value("id").toString()), r.offset);
+    return c.offsets.value(messageId, -1);
+}
+
+bool ConversationStore::pageNeedsDisk(const QUuid& id, int limit, const QUuid& beforeId) const
+{
+    const auto it = m_conversations.constFind(id);
+    if (it == m_conversations.constEnd()) return false;
+
+    const Conversation& c = it.value();
+    if (!c.tailLoaded) return true;
+
+    const int end = tailCursor(c, beforeId);
+    if (end < 0) return true;
+    if (limit >= 0 && end >= limit) return false;
+
+    // в хвосте не хватает — есть ли что-то старше него
+    return c.tail.isEmpty() ? c.bytes > 0 : c.tail.first().offset > 0;
+}
+
+QVector<Message> ConversationStore::page(const QUuid& id, int limit, const QUuid& beforeId)
+{
+    QVector<Message> out;
+    const auto it = m_conversations.find(id);
+    if (it == m_conversations.end() || limit == 0) return out;
+
+    Conversation& c = it.value();
+    if (!c.tailLoaded) loadTail(c);
+
+    int end = tailCursor(c, beforeId);
+    qint64 diskEnd = c.tail.isEmpty() ? c.bytes : c.tail.first().offset;
+    if (end < 0) {
+        end = 0;
+        diskEnd = offsetOf(c, beforeId);
+        if (diskEnd < 0) return out;
+    }
+
+    while (end > 0 && (limit < 0 || out.size() < limit))
+        out.append(c.tail[--end].message);
+    if (end > 0 || (limit >= 0 && out.size() >= limit) || diskEnd <= 0) return out;
+
+    QVector<Journal::Record> records;
+    if (limit < 0) {
+        records = Journal::readRecordsWithOffsets(filePath(c.id));
+        while (!records.isEmpty() && records.last().offset >= diskEnd)
+            records.removeLast();
+    } else {
+        records = Journal::readRecordsBefore(filePath(c.id), diskEnd, limit - int(out.size()));
+    }
+
+    for (int i = int(records.size()) - 1; i >= 0; --i) {
+        const Message m = Message::fromJson(records[i].object);
+        c.offsets.insert(m.getId(), records[i].offset);
+        out.append(m);
+    }
+    return out;
+}
+
+const Message* ConversationStore::messageAt(const QUuid& id, int index) const
+{
+    const auto it = m_conversations.constFind(id);
+    if (it == m_conversations.constEnd() || !it.value().tailLoaded) return nullptr;
+
+    const Conversation& c = it.value();
+    const int i = index - (c.count - int(c.tail.size()));
+    return (i >= 0 && i < c.tail.size()) ? &c.tail[i].message : nullptr;
+}
+
+// ---------------- persistence ----------------
+QJsonObject ConversationStore::toJson() const
+{
+    QJsonArray arr;
+    for (auto it = m_conversations.constBegin(); it != m_conversations.constEnd(); ++it) {
+        const Conversation& c = it.value();
+
+        QJsonArray participants;
+        for (const auto& p : c.participants)
+            participants.append(p.toString(QUuid::WithoutBraces));
+
+        QJsonObject unread;
+        for (auto u = c.unread.constBegin(); u != c.unread.constEnd(); ++u)
+            unread[u.key().toString(QUuid::WithoutBraces)] = u.value();
+
+        QJsonObject o;
+        o["id"] = c.id.toString(QUuid::WithoutBraces);
+        o["participants"] = participants;
+        o["count"] = c.count;
+        o["bytes"] = double(c.bytes);
+        o["unread"] = unread;
+        if (c.count > 0) o["last"] = c.last.toJson();
+        arr.append(o);
+    }
+
+    QJsonObject obj;
+    obj["seq"] = double(m_seq);
+    obj["conversations"] = arr;
+    return obj;
+}
+
+ConversationStore ConversationStore::fromJson(const QJsonObject& obj)
+{
+    ConversationStore store;
+    store.m_seq = qint64(obj.value("seq").toDouble());
+
+    const QJsonArray arr = obj.value("conversations").toArray();
+    store.m_conversations.reserve(arr.size());
+    for (const auto& v : arr) {
+        const QJsonObject o = v.toObject();
+
+        Conversation c;
+        c.id = QUuid(o.value("id").toString());
+        if (c.id.isNull()) continue;
+
+        const QJsonArray participants = o.value("participants").toArray();
+        for (const auto& p : participants) {
+            const QUuid pid(p.toString());
+            if (!pid.isNull()) c.participants.append(pid);
+        }
+
+        c.count = o.value("count").toInt();
+        c.bytes = qint64(o.value("bytes").toDouble());
+        if (o.contains("last")) c.last = Message::fromJson(o.value("last").toObject());
+        else c.lastStale = (c.count > 0);
+
+        const QJsonObject unread = o.value("unread").toObject();
+        for (auto u = unread.constBegin(); u != unread.constEnd(); ++u) {
+            const int n = u.value().toInt();
+            if (n > 0) c.unread.insert(QUuid(u.key()), n);
+        }
+
+        store.m_conversations.insert(c.id, c);
+    }
+    return store;
+}
+
+// ---------------- journal ----------------
+QJsonObject ConversationStore::ensureOp(const QUuid& id, const QVector<QUuid>& participants)
+{
+    QJsonArray arr;
+    for (const auto& p : participants)
+        arr.append(p.toString(QUuid::WithoutBraces));
+
+    QJsonObject op;
+    op["op"] = "ensure";
+    op["id"] = id.toString(QUuid::WithoutBraces);
+    op["participants"] = arr;
+    return op;
+}
+
+QJsonObject ConversationStore::addOp(const QUuid& id, const QJsonObject& record, bool countUnread)
+{
+    QJsonObject op;
+    op["op"] = "add";
+    op["id"] = id.toString(QUuid::WithoutBraces);
+    op["sender"] = record.value("senderId");
+    op["size"] = double(recordSize(record));
+    op["unread"] = countUnread;
+    return op;
+}
+
+QJsonObject ConversationStore::readOp(const QUuid& id, const QUuid& userId)
+{
+    QJsonObject op;
+    op["op"] = "read";
+    op["id"] = id.toString(QUuid::WithoutBraces);
+    op["user"] = userId.toString(QUuid::WithoutBraces);
+    return op;
+}
+
+QJsonObject ConversationStore::dropOp(const QUuid& id)
+{
+    QJsonObject op;
+    op["op"] = "drop";
+    op["id"] = id.toString(QUuid::WithoutBraces);
+    return op;
+}
+
+QJsonObject ConversationStore::stamp(const QJsonObject& op)
+{
+    QJsonObject out = op;
+    out["seq"] = double(++m_seq);
+    return out;
+}
+
+void ConversationStore::applyOp(const QJsonObject& op)
+{
+    const qint64 seq = qint64(op.value("seq").toDouble());
+    if (seq > 0) {
+        if (seq <= m_seq) return; // уже в снапшоте
+        m_seq = seq;
+    }
+
+    const QUuid id(op.value("id").toString());
+    if (id.isNull()) return;
+
+    const QString kind = op.value("op").toString();
+    if (kind == "ensure") {
+        QVector<QUuid> participants;
+        const QJsonArray arr = op.value("participants").toArray();
+        for (const auto& p : arr)
+            participants.append(QUuid(p.toString()));
+        ensure(id, participants);
+    } else if (kind == "add") {
+        Conversation& c = countMessage(id, QUuid(op.value("sender").toString()),
+                                       qint64(op.value("size").toDouble()), op.value("unread").toBool());
+        c.lastStale = true;
+    } else if (kind == "read") {
+        markRead(id, QUuid(op.value("user").toString()));
+    } else if (kind == "drop") {
+        remove(id);
+    }
+}
+
+void ConversationStore::refreshLastMessages()
+{
+    for (auto it = m_conversations.begin(); it != m_conversations.end(); ++it) {
+        Conversation& c = it.value();
+        if (!c.lastStale) continue;
+
+        const QString path = filePath(c.id);
+        const QVector<Journal::Record> records = Journal::readRecordsBefore(path, QFileInfo(path).size(), 1);
+        if (!records.isEmpty()) c.last = Message::fromJson(records.last().object);
+        c.lastStale = false;
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef CONVERSATIONSTORE_H
+#define CONVERSATIONSTORE_H
+
+#include <QHash>
+#include <QString>
+#include <QUuid>
+#include <QVector>
+#include <QJsonObject>
+
+#include "message.h"
+
+// Переписка участников заявки (клиент и исполнитель); id беседы = id заявки.
+// Комментарии заявки — это сообщения её беседы, другого хранилища у них нет.
+// Каждая беседа — свой append-only файл <dir>/<id>.journal, строка JSON на сообщение.
+// В памяти: метаданные всех бесед (conversations.json) и хвост не длиннее kTailSize
+// у открытых. Более старые страницы читаются с диска назад от известного смещения,
+// так что открыть чат стоит одну страницу, а не всю историю.
+class ConversationStore
+{
+public:
+    static const int kTailSize = 200;
+
+    void setDirectory(const QString& dir) { m_dir = dir; }
+    QString filePath(const QUuid& conversationId) const { return filePath(m_dir, conversationId); }
+    static QString filePath(const QString& dir, const QUuid& conversationId);
+
+    bool contains(const QUuid& id) const { return m_conversations.contains(id); }
+    QList<QUuid> ids() const { return m_conversations.keys(); }
+    bool remove(const QUuid& id) { return m_conversations.remove(id) > 0; } // файл удаляет воркер
+    int messageCount(const QUuid& id) const;
+    const Message* lastMessage(const QUuid& id) const; // nullptr — сообщений нет
+
+    // метаданные беседы создаются при первом обращении; участники только добавляются
+    void ensure(const QUuid& id, const QVector<QUuid>& participants);
+
+    // учёт нового сообщения: счётчики, хвост (если загружен), непрочитанные у остальных
+    // (countUnread = false — уже виденная история). Возвращает строку для файла беседы —
+    // её дописывает PersistenceWorker
+    QJsonObject append(const QUuid& id, const Message& m, bool countUnread = true);
+
+    int unread(const QUuid& id, const QUuid& userId) const;
+    bool markRead(const QUuid& id, const QUuid& userId); // false — непрочитанных и не было
+
+    // от новых к старым, строго до beforeId (нулевой — с последнего); limit < 0 — все
+    QVector<Message> page(const QUuid& id, int limit, const QUuid& beforeId);
+    // page() с такими аргументами полезет в файл: перед этим хвост записи надо сбросить на диск
+    bool pageNeedsDisk(const QUuid& id, int limit, const QUuid& beforeId) const;
+    // сообщение с номером index (0 — первое в беседе), если оно в загруженном хвосте; иначе nullptr
+    const Message* messageAt(const QUuid& id, int index) const;
+
+    // ---- persistence (только метаданные) ----
+    QJsonObject toJson() const; // {seq, conversations: [{id, participants, count, bytes, unread, last}]}
+    static ConversationStore fromJson(const QJsonObject& obj);
+
+    // журнал изменений метаданных: снапшот conversations.json переписывается только на checkpoint
+    static QJsonObject ensureOp(const QUuid& id, const QVector<QUuid>& participants);
+    static QJsonObject addOp(const QUuid& id, const QJsonObject& record, bool countUnread); // record — из append()
+    static QJsonObject readOp(const QUuid& id, const QUuid& userId);
+    static QJsonObject dropOp(const QUuid& id);
+    // номер операции журнала: снапшот хранит номер последней учтённой, и при замене
+    // снапшота без очистки журнала (сбой между ними) replay пропускает уже учтённые —
+    // "add" не идемпотентна. Операции без номера (старый журнал) применяются всегда
+    QJsonObject stamp(const QJsonObject& op);
+    void applyOp(const QJsonObject& op);
+    // "add" из журнала не несёт текста: последнее сообщение таких бесед читается
+    // с конца их файлов (задача загрузки, после applyOp)
+    void refreshLastMessages();
+
+private:
+    struct Entry
+    {
+        Message message;
+        qint64 offset = 0;          // начало строки сообщения в файле беседы
+    };
+
+    struct Conversation
+    {
+        QUuid id;
+        QVector<QUuid> participants;
+        int count = 0;
+        qint64 bytes = 0;           // длина файла: смещение следующего сообщения
+        QHash<QUuid, int> unread;   // участник -> непрочитанные
+        Message last;               // последнее сообщение, если count > 0
+
+        // не сохраняются
+        bool lastStale = false;     // last отстаёт от файла: после "add" из журнала
+        bool tailLoaded = false;
+        QVector<Entry> tail;        // последние сообщения, по времени
+        QHash<QUuid, qint64> offsets; // смещения уже прочитанных с диска и вытесненных из хвоста
+    };
+
+    static qint64 recordSize(const QJsonObject& record);
+    Conversation& countMessage(const QUuid& id, const QUuid& senderId, qint64 size, bool countUnread);
+    void loadTail(Conversation& c) const;
+    static int tailCursor(const Conversation& c, const QUuid& beforeId); // -1 — не в хвосте
+    qint64 offsetOf(Conversation& c, const QUuid& messageId) const;
+
+private:
+    QString m_dir;
+    QHash<QUuid, Conversation> m_conversations;
+    qint64 m_seq = 0; // номер последней выданной или применённой операции журнала
+};
+
+#endif // CONVERSATIONSTORE_H
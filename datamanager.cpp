@@ -1,63 +1,51 @@
 #include "datamanager.h"
-
-#include <QCryptographicHash>
-#include <QRandomGenerator>
+#include "persistenceworker.h"
+#include "storage.h"
+#include "journal.h"
+#include "catalogsnapshot.h"
+#include "asyncreply.h"
 
 #include <QFile>
-#include <QDir>
-#include <QStandardPaths>
+#include <QSet>
+#include <QUrl>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QQmlEngine>
 
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 
-// ---------------- paths ----------------
-static QString appDataDir()
-{
-    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir().mkpath(dir);
-    return dir;
-}
-
-static QString servicesFilePath()       { return appDataDir() + "/services.json"; }
-static QString requestsFilePath()       { return appDataDir() + "/requests.json"; }
-static QString reviewsFilePath()        { return appDataDir() + "/reviews.json"; }
-static QString subscriptionsFilePath()  { return appDataDir() + "/subscriptions.json"; }
-static QString favoritesFilePath()      { return appDataDir() + "/favorites.json"; }
+// после стольких записей журнал сворачивается в requests.json
+static const int kRequestsCheckpointEvery = 256;
+static const int kUsersCheckpointEvery = 256;
+static const int kConversationsCheckpointEvery = 256;
+// целевое время одного хеша пароля: под него калибруется число итераций PBKDF2
+static const int kPasswordHashTargetMs = 250;
 
 // ---------------- local helpers ----------------
-static int findProfileByOwner(const QVector<Profile>& profiles, const QUuid& ownerId)
-{
-    for (int i = 0; i < profiles.size(); ++i)
-        if (profiles[i].ownerUserId() == ownerId)
-            return i;
-    return -1;
-}
+// ключи для IdIndex
+static QUuid requestKey(const Request& r) { return r.getId(); }
+static QUuid reviewKey(const Review& r) { return r.getId(); }
+static QUuid subscriptionUserKey(const Subscription& s) { return s.userId(); }
+static QUuid favoritesUserKey(const Favorites& f) { return f.userId(); }
 
-static int indexOfSubscriptionByUser(const QVector<Subscription>& v, const QUuid& uid)
+static QJsonObject requestOp(const QString& op, const QUuid& id)
 {
-    for (int i = 0; i < v.size(); ++i)
-        if (v[i].userId() == uid)
-            return i;
-    return -1;
+    QJsonObject o;
+    o["op"] = op;
+    o["id"] = id.toString(QUuid::WithoutBraces);
+    return o;
 }
 
-static int indexOfFavoritesByUser(const QVector<Favorites>& v, const QUuid& uid)
+// QML FileDialog отдаёт file:// URL, остальные вызовы — обычный путь
+static QString localPathOf(const QString& pathOrUrl)
 {
-    for (int i = 0; i < v.size(); ++i)
-        if (v[i].userId() == uid)
-            return i;
-    return -1;
-}
-
-static Favorites& ensureFavoritesForUser(QVector<Favorites>& v, const QUuid& uid)
-{
-    int idx = indexOfFavoritesByUser(v, uid);
-    if (idx < 0) {
-        v.append(Favorites(QUuid::createUuid(), uid));
-        idx = v.size() - 1;
-    }
-    return v[idx];
+    if (pathOrUrl.startsWith("file:"))
+        return QUrl(pathOrUrl).toLocalFile();
+    return pathOrUrl;
 }
 
 static QDateTime parseIsoMaybeDateOnly(const QString& s)
@@ -73,15 +61,550 @@ static QDateTime parseIsoMaybeDateOnly(const QString& s)
     return dt;
 }
 
+// ---------------- keyset cursors ----------------
+// токен "ключ~id" непрозрачен для QML: его просто возвращают как after
+static QString cursorToken(double key, const QUuid& id)
+{
+    return QString::number(key, 'g', 17) + '~' + id.toString(QUuid::WithoutBraces);
+}
+
+static bool parseCursorToken(const QString& token, double* key, QUuid* id)
+{
+    const int sep = token.lastIndexOf('~');
+    if (sep <= 0) return false;
+
+    bool ok = false;
+    const double k = token.left(sep).toDouble(&ok);
+    const QUuid u(token.mid(sep + 1));
+    if (!ok || u.isNull()) return false;
+
+    *key = k;
+    *id = u;
+    return true;
+}
+
+static qint64 requestCreatedKey(const Request& r) { return createdKey(r); }
+static qint64 reviewCreatedKey(const Review& r) { return createdKey(r); }
+
+// ---------------- conversion helpers ----------------
+// Работают только со своими аргументами, поэтому годятся и для задач пула потоков
+// (там аргументы — снапшоты хранилищ), и для синхронных вызовов.
+static QVariantList servicesToVariantList(const QVector<Service>& v)
+{
+    QVariantList out;
+    out.reserve(v.size());
+    for (const auto& s : v)
+        out.append(s.toJson().toVariantMap());
+    return out;
+}
+
+// строка заявки несёт только число сообщений её беседы и последнее из них; история — в чате.
+// Поля те же, что у ролей RequestListModel: lastComment — текст, lastCommentAt — ISO-время
+static void addCommentSummary(QVariantMap& row, const ConversationStore& comments, const QUuid& requestId)
+{
+    row["commentCount"] = comments.messageCount(requestId);
+    const Message* last = comments.lastMessage(requestId);
+    row["lastComment"] = last ? last->getContent() : QString();
+    row["lastCommentAt"] = last ? last->getTimestamp().toString(Qt::ISODate) : QString();
+}
+
+static QVariantList requestsToVariantList(const QVector<Request>& v, const ConversationStore& comments)
+{
+    QVariantList out;
+    out.reserve(v.size());
+    for (const auto& r : v) {
+        QVariantMap row = r.toJson().toVariantMap();
+        addCommentSummary(row, comments, r.getId());
+        out.append(row);
+    }
+    return out;
+}
+
+static QVariantList servicesPage(const Catalog& catalog, CatalogQuery q, int limit, const QString& after)
+{
+    // keyset требует полного порядка; без явной сортировки — от новых к старым
+    if (q.sort == CatalogQuery::SortNone) q.sort = CatalogQuery::SortNewest;
+    q.limit = limit;
+    q.hasAfter = parseCursorToken(after, &q.afterKey, &q.afterId);
+
+    const QVector<Service> page = catalog.query(q);
+
+    QVariantList out;
+    out.reserve(page.size());
+    for (const auto& s : page) {
+        QVariantMap row = s.toJson().toVariantMap();
+        row["cursor"] = cursorToken(Catalog::sortKey(s, q.sort), s.getId());
+        out.append(row);
+    }
+    return out;
+}
+
+static QVariantList queryCatalog(const Catalog& catalog, const QVariantMap& spec)
+{
+    const CatalogQuery q = CatalogQuery::fromVariantMap(spec);
+    const QString after = spec.value("after").toString();
+    if (!after.isEmpty() || q.limit >= 0)
+        return servicesPage(catalog, q, q.limit, after);
+
+    return servicesToVariantList(catalog.query(q));
+}
+
+// keyset по (createdAt, id), от новых к старым; limit < 0 — до конца
+template <typename T>
+static QVariantList newestFirstPage(const QVector<T>& items, const IdIndex& index,
+                                    const RankIndex<qint64>& byCreatedAt,
+                                    int limit, const QString& after)
+{
+    double afterKey = 0.0;
+    QUuid afterId;
+    const bool hasAfter = parseCursorToken(after, &afterKey, &afterId);
+
+    QVariantList out;
+    auto it = hasAfter ? byCreatedAt.lowerBound(qint64(afterKey), afterId)
+                       : byCreatedAt.end();
+    while (it != byCreatedAt.begin() && (limit < 0 || out.size() < limit)) {
+        --it;
+        const int idx = index.slotOf(it.key().second);
+        if (idx < 0) continue;
+
+        QVariantMap row = items[idx].toJson().toVariantMap();
+        row["cursor"] = cursorToken(double(it.key().first), it.key().second);
+        out.append(row);
+    }
+    return out;
+}
+
+static QVariantList requestsPage(const QVector<Request>& requests, const ConversationStore& comments,
+                                 const IdIndex& index, const RankIndex<qint64>& byCreatedAt,
+                                 int limit, const QString& after)
+{
+    if (limit < 0 && after.isEmpty())
+        return requestsToVariantList(requests, comments);
+
+    QVariantList rows = newestFirstPage(requests, index, byCreatedAt, limit, after);
+    for (auto& v : rows) {
+        QVariantMap row = v.toMap();
+        addCommentSummary(row, comments, QUuid(row.value("id").toString()));
+        v = row;
+    }
+    return rows;
+}
+
+// ---------------- Startup loading ----------------
+// Хранилища независимы: каждое декодируется отдельной задачей в пуле потоков,
+// результат переносится в DataManager в GUI-потоке сразу по готовности,
+// не дожидаясь остальных. Пути считаются заранее, чтобы рабочие потоки
+// не трогали QStandardPaths.
+template <typename T>
+struct StoreLoad
+{
+    T data;
+    qint64 elapsedMs = 0;
+    int journalRecords = 0; // только для хранилищ с журналом
+};
+
+// Заявки грузятся вместе с комментариями старых форматов: массивом "comments" внутри
+// заявки и операциями "comment" в requests.journal, затем отдельным comments.journal.
+// Теперь комментарии — сообщения беседы заявки; найденное здесь переносится в беседы
+struct RequestStore
+{
+    QVector<Request> requests;
+    QHash<QUuid, QVector<Message>> unmigrated; // заявка -> комментарии, которых нет в файле её беседы
+    bool oldCommentSources = false; // старые комментарии ещё на диске: перенос, потом их удаление
+    bool snapshotRead = false; // requests.json прочитан и разобран
+};
+
+typedef QHash<QUuid, QStringList> LegacyComments;
+
+static void applyRequestOp(QVector<Request>& requests, IdIndex& index,
+                           LegacyComments& legacy, const QJsonObject& op)
+{
+    const QString kind = op.value("op").toString();
+
+    if (kind == "create") {
+        const Request r = Request::fromJson(op.value("request").toObject());
+        const int idx = index.slotOf(r.getId());
+        if (idx >= 0) requests[idx] = r;
+        else index.append(requests, r, requestKey);
+        return;
+    }
+
+    const int idx = index.slotOf(QUuid(op.value("id").toString()));
+    if (idx < 0) return;
+
+    if (kind == "delete") {
+        legacy.remove(requests[idx].getId());
+        index.removeAt(requests, idx, requestKey);
+    } else if (kind == "status") {
+        requests[idx].setStatusFromInt(op.value("status").toInt());
+        requests[idx].setCompletedAt(QDateTime::fromString(op.value("completedAt").toString(), Qt::ISODate));
+    } else if (kind == "description") {
+        requests[idx].setDescription(op.value("description").toString());
+    } else if (kind == "comment") {
+        const QString c = op.value("comment").toString().trimmed();
+        if (!c.isEmpty()) legacy[requests[idx].getId()].append(c);
+    }
+}
+
+// comments.journal: {op: "add", requestId, message} / {op: "drop", requestId}
+static QHash<QUuid, QVector<Message>> readCommentsJournal(const QString& path)
+{
+    QHash<QUuid, QVector<Message>> out;
+    const QVector<QJsonObject> ops = Journal::readRecords(path);
+    for (const auto& op : ops) {
+        const QUuid requestId(op.value("requestId").toString());
+        if (requestId.isNull()) continue;
+
+        const QString kind = op.value("op").toString();
+        if (kind == "add") out[requestId].append(Message::fromJson(op.value("message").toObject()));
+        else if (kind == "drop") out.remove(requestId);
+    }
+    return out;
+}
+
+// комментарии живых заявок, которых ещё нет в файлах их бесед; старые (из requests.json)
+// перед записями comments.journal. У старых автор не сохранялся, время — создание заявки,
+// id детерминирован (заявка + номер), поэтому повторный перенос после сбоя находит
+// уже записанное по id и ничего не дублирует
+static void collectUnmigratedComments(RequestStore& store, const IdIndex& index, const LegacyComments& legacy,
+                                      const QHash<QUuid, QVector<Message>>& journal,
+                                      const QString& conversationsDir)
+{
+    QSet<QUuid> requestIds;
+    for (auto it = legacy.constBegin(); it != legacy.constEnd(); ++it) requestIds.insert(it.key());
+    for (auto it = journal.constBegin(); it != journal.constEnd(); ++it) requestIds.insert(it.key());
+
+    for (const auto& rid : requestIds) {
+        const int idx = index.slotOf(rid);
+        if (idx < 0) continue; // заявка удалена вместе с комментариями
+
+        QVector<Message> all;
+        const QStringList texts = legacy.value(rid);
+        const QDateTime at = store.requests[idx].getCreatedAt();
+        for (int i = 0; i < texts.size(); ++i)
+            all.append(Message(QUuid::createUuidV5(rid, QString::number(i)), QUuid(), QUuid(), texts[i], at));
+        all += journal.value(rid);
+
+        QSet<QUuid> present;
+        const QVector<QJsonObject> records = Journal::readRecords(ConversationStore::filePath(conversationsDir, rid));
+        for (const auto& r : records)
+            present.insert(QUuid(r.value("id").toString()));
+
+        QVector<Message> missing;
+        for (const auto& m : all) {
+            if (!present.contains(m.getId())) missing.append(m);
+        }
+        if (!missing.isEmpty()) store.unmigrated.insert(rid, missing);
+    }
+}
+
+static StoreLoad<Catalog> loadServicesFrom(const QString& snapshotPath, const QString& jsonPath)
+{
+    QElapsedTimer t;
+    t.start();
+
+    // основной путь — бинарный снапшот; services.json только если снапшота ещё нет
+    StoreLoad<Catalog> r;
+    if (!CatalogSnapshot::read(snapshotPath, &r.data)) {
+        const QJsonDocument doc = readJsonFile(jsonPath);
+        if (doc.isObject())
+            r.data = Catalog::fromJson(doc.object());
+    }
+
+    r.elapsedMs = t.elapsed();
+    return r;
+}
+
+template <typename T>
+static StoreLoad<QVector<T>> loadJsonArrayFrom(const QString& path)
+{
+    QElapsedTimer t;
+    t.start();
+
+    StoreLoad<QVector<T>> r;
+    const QJsonDocument doc = readJsonFile(path);
+    if (doc.isArray()) {
+        const QJsonArray arr = doc.array();
+        r.data.reserve(arr.size());
+
+        for (const auto& v : arr) {
+            if (!v.isObject()) continue;
+            r.data.append(T::fromJson(v.toObject()));
+        }
+    }
+
+    r.elapsedMs = t.elapsed();
+    return r;
+}
+
+static StoreLoad<RequestStore> loadRequestsFrom(const QString& path, const QString& journalPath,
+                                                const QString& commentsPath, const QString& conversationsDir)
+{
+    QElapsedTimer t;
+    t.start();
+
+    StoreLoad<RequestStore> r;
+    LegacyComments legacy;
+
+    const QJsonDocument doc = readJsonFile(path);
+    r.data.snapshotRead = doc.isArray();
+    if (doc.isArray()) {
+        const QJsonArray arr = doc.array();
+        r.data.requests.reserve(arr.size());
+
+        for (const auto& v : arr) {
+            if (!v.isObject()) continue;
+            const QJsonObject obj = v.toObject();
+            const Request req = Request::fromJson(obj);
+            r.data.requests.append(req);
+
+            const QJsonArray comments = obj.value("comments").toArray();
+            for (const auto& c : comments) {
+                const QString text = c.toString().trimmed();
+                if (!text.isEmpty()) legacy[req.getId()].append(text);
+            }
+        }
+    }
+
+    // снапшот + хвост журнала
+    IdIndex index;
+    index.rebuild(r.data.requests, requestKey);
+
+    const QVector<QJsonObject> ops = Journal::readRecords(journalPath);
+    for (const auto& op : ops)
+        applyRequestOp(r.data.requests, index, legacy, op);
+    r.journalRecords = ops.size();
+
+    const QHash<QUuid, QVector<Message>> journalComments = readCommentsJournal(commentsPath);
+    r.data.oldCommentSources = !legacy.isEmpty() || QFile::exists(commentsPath);
+    if (r.data.oldCommentSources)
+        collectUnmigratedComments(r.data, index, legacy, journalComments, conversationsDir);
+
+    r.elapsedMs = t.elapsed();
+    return r;
+}
+
+// только метаданные бесед; сами сообщения читаются при открытии чата
+static StoreLoad<ConversationStore> loadConversationsFrom(const QString& path, const QString& journalPath,
+                                                          const QString& dir)
+{
+    QElapsedTimer t;
+    t.start();
+
+    StoreLoad<ConversationStore> r;
+    const QJsonDocument doc = readJsonFile(path);
+    if (doc.isObject())
+        r.data = ConversationStore::fromJson(doc.object());
+    r.data.setDirectory(dir);
+
+    // снапшот + хвост журнала
+    const QVector<QJsonObject> ops = Journal::readRecords(journalPath);
+    for (const auto& op : ops)
+        r.data.applyOp(op);
+    r.data.refreshLastMessages();
+    r.journalRecords = ops.size();
+
+    r.elapsedMs = t.elapsed();
+    return r;
+}
+
+static int calibrateKdfTask(int targetMs)
+{
+    return User::calibrateIterations(targetMs);
+}
+
+void DataManager::startLoading()
+{
+    if (m_loadingStarted) return;
+    m_loadingStarted = true;
+    m_loadTimer.start();
+
+    auto* services = new QFutureWatcher<StoreLoad<Catalog>>(this);
+    connect(services, &QFutureWatcherBase::finished, this, &DataManager::onServicesLoaded);
+    services->setFuture(QtConcurrent::run(&loadServicesFrom, servicesSnapshotFilePath(), servicesFilePath()));
+
+    auto* requests = new QFutureWatcher<StoreLoad<RequestStore>>(this);
+    connect(requests, &QFutureWatcherBase::finished, this, &DataManager::onRequestsLoaded);
+    requests->setFuture(QtConcurrent::run(&loadRequestsFrom, requestsFilePath(), requestsJournalFilePath(),
+                                          commentsJournalFilePath(), conversationsDirPath()));
+
+    auto* reviews = new QFutureWatcher<StoreLoad<QVector<Review>>>(this);
+    connect(reviews, &QFutureWatcherBase::finished, this, &DataManager::onReviewsLoaded);
+    reviews->setFuture(QtConcurrent::run(&loadJsonArrayFrom<Review>, reviewsFilePath()));
+
+    auto* subscriptions = new QFutureWatcher<StoreLoad<QVector<Subscription>>>(this);
+    connect(subscriptions, &QFutureWatcherBase::finished, this, &DataManager::onSubscriptionsLoaded);
+    subscriptions->setFuture(QtConcurrent::run(&loadJsonArrayFrom<Subscription>, subscriptionsFilePath()));
+
+    auto* favorites = new QFutureWatcher<StoreLoad<QVector<Favorites>>>(this);
+    connect(favorites, &QFutureWatcherBase::finished, this, &DataManager::onFavoritesLoaded);
+    favorites->setFuture(QtConcurrent::run(&loadJsonArrayFrom<Favorites>, favoritesFilePath()));
+
+    auto* conversations = new QFutureWatcher<StoreLoad<ConversationStore>>(this);
+    connect(conversations, &QFutureWatcherBase::finished, this, &DataManager::onConversationsLoaded);
+    conversations->setFuture(QtConcurrent::run(&loadConversationsFrom, conversationsFilePath(),
+                                                      conversationsJournalFilePath(), conversationsDirPath()));
+}
+
+void DataManager::onServicesLoaded()
+{
+    auto* w = static_cast<QFutureWatcher<StoreLoad<Catalog>>*>(sender());
+    const StoreLoad<Catalog> r = w->result();
+    w->deleteLater();
+
+    m_catalog = r.data;
+    markStoreLoaded(ServicesStore, "services", r.elapsedMs);
+    applyRatingsToCatalog();
+    emit servicesReset();
+    emit servicesChanged();
+}
+
+void DataManager::onRequestsLoaded()
+{
+    auto* w = static_cast<QFutureWatcher<StoreLoad<RequestStore>>*>(sender());
+    const StoreLoad<RequestStore> r = w->result();
+    w->deleteLater();
+
+    m_requests = r.data.requests;
+    m_requestIndex.rebuild(m_requests, requestKey);
+    rebuildRequestIndexes();
+    m_requestOpsSinceCheckpoint = r.journalRecords;
+    m_requestsIntact = r.data.snapshotRead && !m_requests.isEmpty();
+    m_unmigratedComments = r.data.unmigrated;
+    m_oldCommentSources = r.data.oldCommentSources;
+
+    markStoreLoaded(RequestsStore, "requests", r.elapsedMs);
+    migrateComments();
+    dropOrphanConversations();
+    emit requestsReset();
+    emit requestsChanged();
+}
+
+void DataManager::onReviewsLoaded()
+{
+    auto* w = static_cast<QFutureWatcher<StoreLoad<QVector<Review>>>*>(sender());
+    const StoreLoad<QVector<Review>> r = w->result();
+    w->deleteLater();
+
+    m_reviews = r.data;
+    rebuildReviewIndexes();
+    rebuildServiceRatings();
+    markStoreLoaded(ReviewsStore, "reviews", r.elapsedMs);
+    emit reviewsReset();
+    emit reviewsChanged();
+
+    // каталог загрузился раньше — его рейтинги пересчитываются по отзывам
+    if (storeLoaded(ServicesStore)) {
+        applyRatingsToCatalog();
+        emit servicesReset();
+        emit servicesChanged();
+    }
+}
+
+void DataManager::onSubscriptionsLoaded()
+{
+    auto* w = static_cast<QFutureWatcher<StoreLoad<QVector<Subscription>>>*>(sender());
+    const StoreLoad<QVector<Subscription>> r = w->result();
+    w->deleteLater();
+
+    m_subscriptions = r.data;
+    m_subscriptionIndex.rebuild(m_subscriptions, subscriptionUserKey);
+    markStoreLoaded(SubscriptionsStore, "subscriptions", r.elapsedMs);
+    emit subscriptionsChanged();
+}
+
+void DataManager::onFavoritesLoaded()
+{
+    auto* w = static_cast<QFutureWatcher<StoreLoad<QVector<Favorites>>>*>(sender());
+    const StoreLoad<QVector<Favorites>> r = w->result();
+    w->deleteLater();
+
+    m_favorites = r.data;
+    m_favoritesIndex.rebuild(m_favorites, favoritesUserKey);
+    markStoreLoaded(FavoritesStore, "favorites", r.elapsedMs);
+    emit favoritesChanged();
+}
+
+void DataManager::onConversationsLoaded()
+{
+    auto* w = static_cast<QFutureWatcher<StoreLoad<ConversationStore>>*>(sender());
+    const StoreLoad<ConversationStore> r = w->result();
+    w->deleteLater();
+
+    m_conversations = r.data;
+    m_conversationOpsSinceCheckpoint = r.journalRecords;
+    markStoreLoaded(ConversationsStore, "conversations", r.elapsedMs);
+    migrateComments();
+    dropOrphanConversations();
+    emit conversationsReset();
+}
+
+void DataManager::markStoreLoaded(int store, const QString& name, qint64 elapsedMs)
+{
+    m_loadedStores |= store;
+    m_loadReport[name] = elapsedMs;
+    emit loadingProgressChanged();
+
+    if (m_loadedStores != AllStores) return;
+
+    m_loadReport["total"] = m_loadTimer.elapsed();
+    qInfo().noquote() << QString("DataManager: loaded in %1 ms (services %2, requests %3, reviews %4, subscriptions %5, favorites %6, conversations %7)")
+                             .arg(m_loadReport.value("total").toLongLong())
+                             .arg(m_loadReport.value("services").toLongLong())
+                             .arg(m_loadReport.value("requests").toLongLong())
+                             .arg(m_loadReport.value("reviews").toLongLong())
+                             .arg(m_loadReport.value("subscriptions").toLongLong())
+                             .arg(m_loadReport.value("favorites").toLongLong())
+                             .arg(m_loadReport.value("conversations").toLongLong());
+    emit readyChanged();
+
+    // замер стоимости PBKDF2 — после загрузки, чтобы не делить ядра с загрузчиками;
+    // до его конца действует значение по умолчанию
+    auto* kdf = new QFutureWatcher<int>(this);
+    connect(kdf, &QFutureWatcherBase::finished, this, &DataManager::onKdfCalibrated);
+    kdf->setFuture(QtConcurrent::run(&calibrateKdfTask, kPasswordHashTargetMs));
+}
+
+double DataManager::loadingProgress() const
+{
+    int n = 0;
+    for (int bit = ServicesStore; bit <= ConversationsStore; bit <<= 1)
+        if (m_loadedStores & bit) ++n;
+    return double(n) / 6.0;
+}
+
 // ---------------- DataManager ----------------
 DataManager::DataManager(QObject* parent)
     : QObject(parent)
+    , m_persistence(new PersistenceWorker)
+{
+    m_persistence->moveToThread(&m_persistenceThread);
+    connect(&m_persistenceThread, &QThread::finished, m_persistence, &QObject::deleteLater);
+    m_persistenceThread.start();
+
+    m_currentUser.id = QUuid();
+
+    // хранилища грузятся в фоне: startLoading() вызывается после engine.load() в main.cpp
+}
+
+DataManager::~DataManager()
+{
+    shutdown();
+}
+
+void DataManager::flush()
 {
-    loadServices();
-    loadRequests();
-    loadReviews();
-    loadSubscriptions();
-    loadFavorites();
+    if (m_persistence) m_persistence->flush();
+}
+
+void DataManager::shutdown()
+{
+    if (!m_persistenceThread.isRunning()) return;
+
+    flush();
+    m_persistenceThread.quit();
+    m_persistenceThread.wait();
+    m_persistence = nullptr; // удалён через deleteLater по finished
 }
 
 DataManager& DataManager::instance()
@@ -92,65 +615,267 @@ DataManager& DataManager::instance()
 
 QString DataManager::currentUserRole() const
 {
-    switch (m_currentUser.roleIndex) {
-    case 0: return "Client";
-    case 1: return "Provider";
-    case 2: return "Admin";
-    default: return "Client";
-    }
+    return User::roleToString(m_currentUser.role);
+}
+
+// ---------------- Users storage ----------------
+static StoreLoad<UserStore> loadUsersFrom(const QString& path, const QString& journalPath)
+{
+    QElapsedTimer t;
+    t.start();
+
+    StoreLoad<UserStore> r;
+    const QJsonDocument doc = readJsonFile(path);
+    if (doc.isObject())
+        r.data = UserStore::fromJson(doc.object());
+
+    // снапшот + хвост журнала
+    const QVector<QJsonObject> ops = Journal::readRecords(journalPath);
+    for (const auto& op : ops)
+        r.data.applyOp(op);
+    r.journalRecords = ops.size();
+
+    r.elapsedMs = t.elapsed();
+    return r;
 }
 
-QString DataManager::hashPasswordHex(const QString& pass)
+// Пользователи не входят в startLoading: их читают при первом обращении
+// (логин, регистрация), сеанс без входа файл пользователей не трогает.
+void DataManager::startUsersLoad()
 {
-    const QByteArray h = QCryptographicHash::hash(pass.toUtf8(), QCryptographicHash::Sha256);
-    return QString::fromLatin1(h.toHex());
+    if (m_usersLoaded || m_usersLoad) return;
+
+    auto* w = new QFutureWatcher<StoreLoad<UserStore>>(this);
+    connect(w, &QFutureWatcherBase::finished, this, &DataManager::onUsersLoaded);
+    w->setFuture(QtConcurrent::run(&loadUsersFrom, usersFilePath(), usersJournalFilePath()));
+    m_usersLoad = w;
 }
 
-QString DataManager::genCode6()
+// синхронные login/registerUser: то же чтение, но с ожиданием
+void DataManager::ensureUsersLoaded()
 {
-    const int v = int(QRandomGenerator::global()->bounded(0, 1000000));
-    return QString("%1").arg(v, 6, 10, QLatin1Char('0'));
+    if (m_usersLoaded) return;
+    startUsersLoad();
+    m_usersLoad->waitForFinished();
+    applyUsersLoad();
 }
 
-int DataManager::findUserByEmailOrPhone(const QString& s) const
+void DataManager::applyUsersLoad()
 {
-    const QString key = s.trimmed();
-    if (key.isEmpty()) return -1;
+    auto* w = static_cast<QFutureWatcher<StoreLoad<UserStore>>*>(m_usersLoad);
+    m_usersLoad = nullptr;
+    w->disconnect(this); // finished мог уже стоять в очереди
+    const StoreLoad<UserStore> r = w->result();
+    w->deleteLater();
 
-    for (int i = 0; i < m_users.size(); ++i) {
-        if (m_users[i].email.compare(key, Qt::CaseInsensitive) == 0) return i;
-        if (!m_users[i].phone.isEmpty() && m_users[i].phone == key) return i;
-    }
-    return -1;
+    m_userStore = r.data;
+    m_userOpsSinceCheckpoint = r.journalRecords;
+    m_usersLoaded = true;
+    m_loadReport["users"] = r.elapsedMs;
+
+    // операция *Async, начатая до чтения
+    const PendingAuth p = m_pendingAuth;
+    m_pendingAuth = PendingAuth();
+    if (p.kind == PendingAuth::Login) startLogin(p.login, p.password);
+    else if (p.kind == PendingAuth::Register) startRegister(p.login, p.phone, p.roleIndex, p.password);
+}
+
+void DataManager::onUsersLoaded()
+{
+    if (m_usersLoad) applyUsersLoad(); // иначе его уже дождался синхронный вызов
+}
+
+void DataManager::saveUsers() const
+{
+    if (m_persistence) m_persistence->submitUsers(m_userStore);
+}
+
+void DataManager::logUserOp(const QJsonObject& op)
+{
+    if (m_persistence) m_persistence->appendUserOp(op);
+    if (++m_userOpsSinceCheckpoint >= kUsersCheckpointEvery)
+        checkpointUsers();
+}
+
+void DataManager::checkpointUsers()
+{
+    saveUsers();
+    m_userOpsSinceCheckpoint = 0;
+}
+
+void DataManager::storeCurrentUser()
+{
+    m_userStore.putUser(m_currentUser);
+    logUserOp(UserStore::userOp(m_currentUser));
+}
+
+// ---------------- Password hashing ----------------
+// Задачи пула: работают с копией User, в хранилище результат кладёт GUI-поток.
+struct PasswordJob
+{
+    User user;
+    bool ok = false;
+    bool rehashed = false; // старый формат или дешёвая стоимость -> пароль перехеширован
+};
+
+static PasswordJob setPasswordTask(const User& user, const QString& password)
+{
+    PasswordJob job;
+    job.user = user;
+    job.ok = job.user.setPassword(password);
+    return job;
+}
+
+static PasswordJob verifyPasswordTask(const User& user, const QString& password)
+{
+    PasswordJob job;
+    job.user = user;
+    job.ok = job.user.checkPassword(password);
+    if (job.ok && job.user.needsRehash())
+        job.rehashed = job.user.setPassword(password);
+    return job;
+}
+
+// неизвестный логин: тот же PBKDF2 текущей стоимости, что у проверки настоящего пароля,
+// чтобы отказ по времени не отличался от неверного пароля. Ответ всегда ok = false
+static PasswordJob unknownLoginTask(const QString& password)
+{
+    User dummy;
+    dummy.passwordSalt = QString(32, QLatin1Char('0'));
+    dummy.passwordHash = QString(64, QLatin1Char('0'));
+    dummy.passwordIterations = User::defaultIterations();
+    dummy.checkPassword(password);
+    return PasswordJob();
+}
+
+static PasswordJob changePasswordTask(const User& user, const QString& oldPass, const QString& newPass)
+{
+    PasswordJob job;
+    job.user = user;
+    job.ok = job.user.changePassword(oldPass, newPass);
+    return job;
+}
+
+void DataManager::onKdfCalibrated()
+{
+    auto* w = static_cast<QFutureWatcher<int>*>(sender());
+    const int iterations = w->result();
+    w->deleteLater();
+
+    User::setDefaultIterations(iterations);
+    m_loadReport["kdfIterations"] = User::defaultIterations();
+}
+
+bool DataManager::beginAuth()
+{
+    if (m_authBusy) return false;
+    m_authBusy = true;
+    emit authBusyChanged();
+    return true;
+}
+
+void DataManager::endAuth()
+{
+    m_authBusy = false;
+    emit authBusyChanged();
 }
 
 // ---------------- Auth/User ----------------
+bool DataManager::canRegister(const QString& email, const QString& phone, const QString& password) const
+{
+    if (email.trimmed().isEmpty() || password.size() < 6) return false;
+    if (m_userStore.findByEmail(email)) return false;
+    if (m_userStore.findByPhone(phone)) return false;
+    return true;
+}
+
+static User newUser(const QString& email, const QString& phone, int roleIndex)
+{
+    User u;
+    u.email = email.trimmed();
+    u.phone = phone.trimmed();
+    u.role = User::roleFromInt(roleIndex);
+    return u;
+}
+
+bool DataManager::finishRegister(const User& user, bool ok)
+{
+    if (!ok) return false;
+    // пока считался хеш, email или телефон мог занять кто-то другой
+    if (m_userStore.findByEmail(user.email) || m_userStore.findByPhone(user.phone)) return false;
+
+    m_currentUser = user;
+    storeCurrentUser();
+    m_loggedIn = true;
+
+    emit currentUserChanged();
+    emit loggedInChanged();
+    return true;
+}
+
 bool DataManager::registerUser(const QString& email,
                                const QString& phone,
                                int roleIndex,
                                const QString& password)
 {
-    const QString em = email.trimmed();
-    const QString ph = phone.trimmed();
-    if (em.isEmpty() || password.size() < 6) return false;
+    ensureUsersLoaded();
+    if (!canRegister(email, phone, password)) return false;
 
-    for (const auto& u : m_users) {
-        if (u.email.compare(em, Qt::CaseInsensitive) == 0) return false;
-        if (!ph.isEmpty() && !u.phone.isEmpty() && u.phone == ph) return false;
+    const PasswordJob job = setPasswordTask(newUser(email, phone, roleIndex), password);
+    return finishRegister(job.user, job.ok);
+}
+
+void DataManager::registerUserAsync(const QString& email,
+                                    const QString& phone,
+                                    int roleIndex,
+                                    const QString& password)
+{
+    if (!beginAuth()) {
+        emit registerFinished(false);
+        return;
+    }
+    if (!m_usersLoaded) {
+        m_pendingAuth.kind = PendingAuth::Register;
+        m_pendingAuth.login = email;
+        m_pendingAuth.phone = phone;
+        m_pendingAuth.roleIndex = roleIndex;
+        m_pendingAuth.password = password;
+        startUsersLoad();
+        return;
+    }
+    startRegister(email, phone, roleIndex, password);
+}
+
+void DataManager::startRegister(const QString& email, const QString& phone, int roleIndex,
+                                const QString& password)
+{
+    if (!canRegister(email, phone, password)) {
+        endAuth();
+        emit registerFinished(false);
+        return;
     }
 
-    UserRec u;
-    u.id = QUuid::createUuid();
-    u.email = em;
-    u.phone = ph;
-    u.roleIndex = qBound(0, roleIndex, 2);
-    u.passHashHex = hashPasswordHex(password);
-    u.createdAt = QDateTime::currentDateTime();
-    u.verified = false;
-    u.verificationCode.clear();
+    auto* w = new QFutureWatcher<PasswordJob>(this);
+    connect(w, &QFutureWatcherBase::finished, this, &DataManager::onRegisterHashed);
+    w->setFuture(QtConcurrent::run(&setPasswordTask, newUser(email, phone, roleIndex), password));
+}
 
-    m_users.append(u);
-    m_currentUser = u;
+void DataManager::onRegisterHashed()
+{
+    auto* w = static_cast<QFutureWatcher<PasswordJob>*>(sender());
+    const PasswordJob job = w->result();
+    w->deleteLater();
+
+    endAuth();
+    emit registerFinished(finishRegister(job.user, job.ok));
+}
+
+bool DataManager::finishLogin(const User& user, bool ok, bool rehashed)
+{
+    if (!ok) return false;
+
+    m_currentUser = user;
+    if (rehashed) storeCurrentUser();
     m_loggedIn = true;
 
     emit currentUserChanged();
@@ -160,23 +885,55 @@ bool DataManager::registerUser(const QString& email,
 
 bool DataManager::login(const QString& emailOrPhone, const QString& password)
 {
-    const int idx = findUserByEmailOrPhone(emailOrPhone);
-    if (idx < 0) return false;
-    if (m_users[idx].passHashHex != hashPasswordHex(password)) return false;
+    ensureUsersLoaded();
 
-    m_currentUser = m_users[idx];
-    m_loggedIn = true;
+    const User* u = m_userStore.findByLogin(emailOrPhone);
+    const PasswordJob job = u ? verifyPasswordTask(*u, password) : unknownLoginTask(password);
+    return finishLogin(job.user, job.ok, job.rehashed);
+}
 
-    emit currentUserChanged();
-    emit loggedInChanged();
-    return true;
+void DataManager::loginAsync(const QString& emailOrPhone, const QString& password)
+{
+    if (!beginAuth()) {
+        emit loginFinished(false);
+        return;
+    }
+    if (!m_usersLoaded) {
+        m_pendingAuth.kind = PendingAuth::Login;
+        m_pendingAuth.login = emailOrPhone;
+        m_pendingAuth.password = password;
+        startUsersLoad();
+        return;
+    }
+    startLogin(emailOrPhone, password);
+}
+
+void DataManager::startLogin(const QString& emailOrPhone, const QString& password)
+{
+    const User* u = m_userStore.findByLogin(emailOrPhone);
+
+    auto* w = new QFutureWatcher<PasswordJob>(this);
+    connect(w, &QFutureWatcherBase::finished, this, &DataManager::onLoginHashed);
+    w->setFuture(u ? QtConcurrent::run(&verifyPasswordTask, *u, password)
+                   : QtConcurrent::run(&unknownLoginTask, password));
+}
+
+void DataManager::onLoginHashed()
+{
+    auto* w = static_cast<QFutureWatcher<PasswordJob>*>(sender());
+    const PasswordJob job = w->result();
+    w->deleteLater();
+
+    endAuth();
+    emit loginFinished(finishLogin(job.user, job.ok, job.rehashed));
 }
 
 void DataManager::logout()
 {
     if (!m_loggedIn) return;
     m_loggedIn = false;
-    m_currentUser = UserRec();
+    m_currentUser = User();
+    m_currentUser.id = QUuid(); // User() выдаёт новый id, а «никто» — это нулевой
 
     emit currentUserChanged();
     emit loggedInChanged();
@@ -186,55 +943,65 @@ QString DataManager::issueVerificationCode()
 {
     if (!m_loggedIn) return QString();
 
-    const QString code = genCode6();
-    for (auto& u : m_users) {
-        if (u.id == m_currentUser.id) {
-            u.verificationCode = code;
-            m_currentUser.verificationCode = code;
-            break;
-        }
-    }
+    // в хранилище попадает только хеш кода
+    const QString code = m_currentUser.issueVerificationCode();
+    storeCurrentUser();
+    emit currentUserChanged();
     return code;
 }
 
 bool DataManager::verifyAccount(const QString& code)
 {
     if (!m_loggedIn) return false;
+    if (!m_currentUser.verifyAccount(code.trimmed())) return false;
 
-    const QString c = code.trimmed();
-    for (auto& u : m_users) {
-        if (u.id != m_currentUser.id) continue;
+    storeCurrentUser();
+    emit currentUserChanged();
+    return true;
+}
 
-        if (!u.verificationCode.isEmpty() && u.verificationCode == c) {
-            u.verified = true;
-            u.verificationCode.clear();
-            m_currentUser = u;
-            emit currentUserChanged();
-            return true;
-        }
-        return false;
-    }
-    return false;
+bool DataManager::finishPasswordChange(const User& user, bool ok)
+{
+    // за время хеширования могли выйти или сменить пользователя
+    if (!ok || !m_loggedIn || user.id != m_currentUser.id) return false;
+
+    // остальные поля могли поменяться параллельно — берём только пароль
+    m_currentUser.passwordSalt = user.passwordSalt;
+    m_currentUser.passwordHash = user.passwordHash;
+    m_currentUser.passwordIterations = user.passwordIterations;
+    storeCurrentUser();
+    emit currentUserChanged();
+    return true;
 }
 
 bool DataManager::changePassword(const QString& oldPass, const QString& newPass)
 {
     if (!m_loggedIn) return false;
-    if (newPass.size() < 6) return false;
 
-    const QString oldH = hashPasswordHex(oldPass);
-    const QString newH = hashPasswordHex(newPass);
-
-    for (auto& u : m_users) {
-        if (u.id != m_currentUser.id) continue;
-        if (u.passHashHex != oldH) return false;
+    const PasswordJob job = changePasswordTask(m_currentUser, oldPass, newPass);
+    return finishPasswordChange(job.user, job.ok);
+}
 
-        u.passHashHex = newH;
-        m_currentUser = u;
-        emit currentUserChanged();
-        return true;
+void DataManager::changePasswordAsync(const QString& oldPass, const QString& newPass)
+{
+    if (!m_loggedIn || newPass.size() < 6 || !beginAuth()) {
+        emit passwordChangeFinished(false);
+        return;
     }
-    return false;
+
+    auto* w = new QFutureWatcher<PasswordJob>(this);
+    connect(w, &QFutureWatcherBase::finished, this, &DataManager::onPasswordChangeHashed);
+    w->setFuture(QtConcurrent::run(&changePasswordTask, m_currentUser, oldPass, newPass));
+}
+
+void DataManager::onPasswordChangeHashed()
+{
+    auto* w = static_cast<QFutureWatcher<PasswordJob>*>(sender());
+    const PasswordJob job = w->result();
+    w->deleteLater();
+
+    endAuth();
+    emit passwordChangeFinished(finishPasswordChange(job.user, job.ok));
 }
 
 // ---------------- Profile ----------------
@@ -244,11 +1011,8 @@ QVariantMap DataManager::getMyProfile() const
     if (!m_loggedIn) return out;
 
     const QUuid ownerId = m_currentUser.id;
-    const int idx = findProfileByOwner(m_profiles, ownerId);
-
-    Profile p;
-    if (idx >= 0) p = m_profiles[idx];
-    else p = Profile(QUuid::createUuid(), ownerId, "", "");
+    const Profile* stored = m_userStore.findProfile(ownerId);
+    const Profile p = stored ? *stored : Profile(QUuid::createUuid(), ownerId, "", "");
 
     out["profileId"] = p.profileId().toString(QUuid::WithoutBraces);
     out["ownerUserId"] = p.ownerUserId().toString(QUuid::WithoutBraces);
@@ -270,13 +1034,9 @@ bool DataManager::saveMyProfile(const QString& name,
     if (!m_loggedIn) return false;
 
     const QUuid ownerId = m_currentUser.id;
-    int idx = findProfileByOwner(m_profiles, ownerId);
-    if (idx < 0) {
-        m_profiles.append(Profile(QUuid::createUuid(), ownerId, "", ""));
-        idx = m_profiles.size() - 1;
-    }
+    const Profile* stored = m_userStore.findProfile(ownerId);
 
-    Profile p = m_profiles[idx];
+    Profile p = stored ? *stored : Profile(QUuid::createUuid(), ownerId, "", "");
     p.setOwnerUserId(ownerId);
     p.setName(name);
     p.setDescription(description);
@@ -285,84 +1045,149 @@ bool DataManager::saveMyProfile(const QString& name,
     p.setContactPhone(contactPhone);
     p.setVerified(m_currentUser.verified);
 
-    m_profiles[idx] = p;
+    m_userStore.putProfile(p);
+    logUserOp(UserStore::profileOp(p));
     return true;
 }
 
 // ---------------- Services storage ----------------
-void DataManager::loadServices()
-{
-    QFile f(servicesFilePath());
-    if (!f.open(QIODevice::ReadOnly)) return;
-
-    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
-    if (!doc.isObject()) return;
-
-    m_catalog = Catalog::fromJson(doc.object());
-}
-
 void DataManager::saveServices() const
 {
-    QFile f(servicesFilePath());
-    if (!f.open(QIODevice::WriteOnly)) return;
-
-    const QJsonDocument doc(m_catalog.toJson());
-    f.write(doc.toJson(QJsonDocument::Indented));
+    if (m_persistence) m_persistence->submitServices(CatalogSnapshot::dataOf(m_catalog));
 }
 
-QVariantList DataManager::servicesToVariantList(const QVector<Service>& v)
+QVariantList DataManager::getAllServices(int limit, const QString& after) const
 {
-    QVariantList out;
-    out.reserve(v.size());
-    for (const auto& s : v)
-        out.append(s.toJson().toVariantMap());
-    return out;
+    if (limit < 0 && after.isEmpty())
+        return servicesToVariantList(m_catalog.getAllServices());
+
+    return servicesPage(m_catalog, CatalogQuery(), limit, after);
 }
 
-QVariantList DataManager::getAllServices() const
+QString DataManager::newServiceId() const
 {
-    return servicesToVariantList(m_catalog.getAllServices());
+    return QUuid::createUuid().toString(QUuid::WithoutBraces);
+}
+
+QVariantMap DataManager::getService(const QString& serviceId) const
+{
+    const Service* s = m_catalog.findService(QUuid(serviceId.trimmed()));
+    return s ? s->toJson().toVariantMap() : QVariantMap();
 }
 
 bool DataManager::addService(const QVariantMap& serviceMap)
 {
+    if (!storeLoaded(ServicesStore)) return false;
+
     const QJsonObject obj = QJsonObject::fromVariantMap(serviceMap);
     const Service s = Service::fromJson(obj);
+    const Service* old = m_catalog.findService(s.getId());
+    const bool replaced = (old != nullptr);
+    const QUuid oldProviderId = old ? old->getProviderId() : QUuid();
 
     m_catalog.addService(s);
+    syncServiceRating(s.getId(), oldProviderId);
     saveServices();
+    if (replaced) emit serviceUpdated(s.getId());
+    else emit serviceAdded(s.getId());
     emit servicesChanged();
     return true;
 }
 
 bool DataManager::updateService(const QVariantMap& serviceMap)
 {
+    if (!storeLoaded(ServicesStore)) return false;
+
     const QJsonObject obj = QJsonObject::fromVariantMap(serviceMap);
     const Service s = Service::fromJson(obj);
+    const Service* old = m_catalog.findService(s.getId());
+    const QUuid oldProviderId = old ? old->getProviderId() : QUuid();
 
     if (!m_catalog.updateService(s)) return false;
 
+    syncServiceRating(s.getId(), oldProviderId);
     saveServices();
+    emit serviceUpdated(s.getId());
     emit servicesChanged();
     return true;
 }
 
 bool DataManager::deleteService(const QString& serviceId)
 {
+    if (!storeLoaded(ServicesStore)) return false;
+
     const QUuid id(serviceId.trimmed());
     if (id.isNull()) return false;
 
+    const Service* old = m_catalog.findService(id);
+    const QUuid oldProviderId = old ? old->getProviderId() : QUuid();
+
     if (!m_catalog.removeService(id)) return false;
 
+    syncServiceRating(id, oldProviderId);
+    saveServices();
+    emit serviceRemoved(id);
+    emit servicesChanged();
+    return true;
+}
+
+static QString catalogJsonPath(const QString& path)
+{
+    return path.trimmed().isEmpty() ? servicesFilePath() : localPathOf(path.trimmed());
+}
+
+static bool writeCatalogJson(const Catalog& catalog, const QString& path)
+{
+    return writeJsonFile(path, QJsonDocument(catalog.toJson()));
+}
+
+struct CatalogImport
+{
+    Catalog catalog;
+    bool ok = false;
+};
+
+// разбор JSON и сборка всех индексов каталога; GUI-поток потом только подменяет каталог
+static CatalogImport readCatalogJson(const QString& path)
+{
+    CatalogImport r;
+    const QJsonDocument doc = readJsonFile(path);
+    if (!doc.isObject()) return r;
+
+    r.catalog = Catalog::fromJson(doc.object());
+    r.ok = true;
+    return r;
+}
+
+bool DataManager::exportCatalogJson(const QString& path) const
+{
+    return writeCatalogJson(m_catalog, catalogJsonPath(path));
+}
+
+bool DataManager::importCatalogJson(const QString& path)
+{
+    if (!storeLoaded(ServicesStore)) return false;
+
+    const CatalogImport r = readCatalogJson(catalogJsonPath(path));
+    if (!r.ok) return false;
+
+    m_catalog = r.catalog;
+    applyRatingsToCatalog();
     saveServices();
+    emit servicesReset();
     emit servicesChanged();
     return true;
 }
 
 // ---------------- Catalog wrappers ----------------
-QVariantList DataManager::catalogGetActiveServices() const
+QVariantList DataManager::catalogGetActiveServices(int limit, const QString& after) const
 {
-    return servicesToVariantList(m_catalog.getActiveServices());
+    if (limit < 0 && after.isEmpty())
+        return servicesToVariantList(m_catalog.getActiveServices());
+
+    CatalogQuery q;
+    q.activeOnly = true;
+    return servicesPage(m_catalog, q, limit, after);
 }
 
 QVariantList DataManager::catalogSearchByName(const QString& name)
@@ -377,19 +1202,52 @@ QVariantList DataManager::catalogSearchByDescription(const QString& text)
     return servicesToVariantList(m_catalog.searchByDescription(text));
 }
 
-QVariantList DataManager::catalogFilterByCategory(const QString& category) const
+QVariantList DataManager::catalogSearchByWords(const QString& query)
+{
+    m_catalog.addSearchHistory(query);
+    return servicesToVariantList(m_catalog.searchByWords(query));
+}
+
+QVariantList DataManager::catalogQuery(const QVariantMap& spec) const
+{
+    return queryCatalog(m_catalog, spec);
+}
+
+QVariantList DataManager::catalogFilterByCategory(const QString& category,
+                                                  int limit, const QString& after) const
 {
-    return servicesToVariantList(m_catalog.filterByCategory(category));
+    if (limit < 0 && after.isEmpty())
+        return servicesToVariantList(m_catalog.filterByCategory(category));
+
+    // пустая категория у filterByCategory означает пустой результат, а не "без фильтра"
+    if (category.trimmed().isEmpty()) return QVariantList();
+
+    CatalogQuery q;
+    q.category = category;
+    return servicesPage(m_catalog, q, limit, after);
 }
 
-QVariantList DataManager::catalogFilterByPrice(double minPrice, double maxPrice) const
+QVariantList DataManager::catalogFilterByPrice(double minPrice, double maxPrice,
+                                               int limit, const QString& after) const
 {
-    return servicesToVariantList(m_catalog.filterByPrice(minPrice, maxPrice));
+    if (limit < 0 && after.isEmpty())
+        return servicesToVariantList(m_catalog.filterByPrice(minPrice, maxPrice));
+
+    CatalogQuery q;
+    q.minPrice = minPrice;
+    q.maxPrice = maxPrice;
+    return servicesPage(m_catalog, q, limit, after);
 }
 
-QVariantList DataManager::catalogFilterByRating(double minRating) const
+QVariantList DataManager::catalogFilterByRating(double minRating,
+                                                int limit, const QString& after) const
 {
-    return servicesToVariantList(m_catalog.filterByRating(minRating));
+    if (limit < 0 && after.isEmpty())
+        return servicesToVariantList(m_catalog.filterByRating(minRating));
+
+    CatalogQuery q;
+    q.minRating = minRating;
+    return servicesPage(m_catalog, q, limit, after);
 }
 
 QVariantList DataManager::catalogGetPopularServices(int count) const
@@ -412,6 +1270,11 @@ QStringList DataManager::catalogGetSearchHistory() const
     return m_catalog.getSearchHistory();
 }
 
+void DataManager::catalogAddSearchHistory(const QString& query)
+{
+    m_catalog.addSearchHistory(query);
+}
+
 QString DataManager::catalogGetInfo() const
 {
     return m_catalog.getInfo();
@@ -422,63 +1285,312 @@ QString DataManager::catalogGetFullInfo() const
     return m_catalog.getFullInfo();
 }
 
-// ---------------- Requests storage ----------------
-void DataManager::loadRequests()
+// ---------------- Async API ----------------
+// Задачи получают снапшоты хранилищ по значению: GUI-поток может менять данные
+// дальше (его копия отсоединится при первой записи), задача дочитает свою версию.
+static QVariant queryCatalogTask(const Catalog& catalog, const QVariantMap& spec)
+{
+    return queryCatalog(catalog, spec);
+}
+
+static QVariant requestsPageTask(const QVector<Request>& requests, const ConversationStore& comments,
+                                 const IdIndex& index, const RankIndex<qint64>& byCreatedAt,
+                                 int limit, const QString& after)
+{
+    return requestsPage(requests, comments, index, byCreatedAt, limit, after);
+}
+
+static QVariant writeCatalogJsonTask(const Catalog& catalog, const QString& path)
+{
+    return writeCatalogJson(catalog, path);
+}
+
+static AsyncReply* newAsyncReply()
+{
+    // без родителя и не во власти GC QML: ответ удаляет себя сам после finished
+    auto* reply = new AsyncReply;
+    QQmlEngine::setObjectOwnership(reply, QQmlEngine::CppOwnership);
+    return reply;
+}
+
+AsyncReply* DataManager::catalogQueryAsync(const QVariantMap& spec) const
+{
+    AsyncReply* reply = newAsyncReply();
+    reply->watch(QtConcurrent::run(&queryCatalogTask, m_catalog, spec));
+    return reply;
+}
+
+AsyncReply* DataManager::getAllRequestsAsync(int limit, const QString& after) const
+{
+    AsyncReply* reply = newAsyncReply();
+    reply->watch(QtConcurrent::run(&requestsPageTask, m_requests, m_conversations, m_requestIndex,
+                                   m_requestsByCreatedAt, limit, after));
+    return reply;
+}
+
+AsyncReply* DataManager::exportCatalogJsonAsync(const QString& path) const
+{
+    AsyncReply* reply = newAsyncReply();
+    reply->watch(QtConcurrent::run(&writeCatalogJsonTask, m_catalog, catalogJsonPath(path)));
+    return reply;
+}
+
+AsyncReply* DataManager::importCatalogJsonAsync(const QString& path)
 {
-    QFile f(requestsFilePath());
-    if (!f.open(QIODevice::ReadOnly)) return;
+    AsyncReply* reply = newAsyncReply();
+    if (!storeLoaded(ServicesStore)) {
+        reply->complete(false);
+        return reply;
+    }
 
-    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
-    if (!doc.isArray()) return;
+    // watcher — дочерний объект ответа: по нему onCatalogImported находит, кому отвечать
+    auto* w = new QFutureWatcher<CatalogImport>(reply);
+    connect(w, &QFutureWatcherBase::finished, this, &DataManager::onCatalogImported);
+    w->setFuture(QtConcurrent::run(&readCatalogJson, catalogJsonPath(path)));
+    return reply;
+}
 
-    m_requests.clear();
-    const QJsonArray arr = doc.array();
-    m_requests.reserve(arr.size());
+void DataManager::onCatalogImported()
+{
+    auto* w = static_cast<QFutureWatcher<CatalogImport>*>(sender());
+    auto* reply = static_cast<AsyncReply*>(w->parent());
+    const CatalogImport r = w->result();
+    w->deleteLater();
 
-    for (const auto& v : arr) {
-        if (!v.isObject()) continue;
-        m_requests.append(Request::fromJson(v.toObject()));
+    if (r.ok) {
+        m_catalog = r.catalog;
+        applyRatingsToCatalog();
+        saveServices();
+        emit servicesReset();
+        emit servicesChanged();
     }
+    reply->complete(r.ok);
 }
 
+// ---------------- Requests storage ----------------
 void DataManager::saveRequests() const
 {
-    QJsonArray arr;
+    if (m_persistence) m_persistence->submitRequests(m_requests);
+}
+
+void DataManager::logRequestOp(const QJsonObject& op)
+{
+    if (m_persistence) m_persistence->appendRequestOp(op);
+    if (++m_requestOpsSinceCheckpoint >= kRequestsCheckpointEvery)
+        checkpointRequests();
+}
+
+void DataManager::checkpointRequests()
+{
+    // воркер пишет снапшот атомарно (QSaveFile), и только потом обнуляет журнал
+    saveRequests();
+    m_requestOpsSinceCheckpoint = 0;
+}
+
+int DataManager::indexOfRequest(const QUuid& id) const
+{
+    return m_requestIndex.slotOf(id);
+}
+
+const Request* DataManager::findRequest(const QUuid& id) const
+{
+    const int idx = indexOfRequest(id);
+    return idx >= 0 ? &m_requests[idx] : nullptr;
+}
+
+// ---------------- Request indexes ----------------
+template <typename Key>
+static void removeFromIndex(QHash<Key, RankIndex<qint64>>& index, const Key& key,
+                            qint64 createdAt, const QUuid& id)
+{
+    auto it = index.find(key);
+    if (it == index.end()) return;
+    it.value().remove(createdAt, id);
+    if (it.value().size() == 0) index.erase(it);
+}
+
+void DataManager::indexRequest(const Request& r)
+{
+    const qint64 key = requestCreatedKey(r);
+    const int status = r.getStatusIndex();
+    m_requestsByCreatedAt.insert(key, r.getId());
+    m_requestsByClient[r.getClientId()].insert(key, r.getId());
+    m_requestsByProvider[r.getProviderId()].insert(key, r.getId());
+    m_requestsByService[r.getServiceId()].insert(key, r.getId());
+    m_requestsByStatus[status].insert(key, r.getId());
+    m_requestsByClientStatus[qMakePair(r.getClientId(), status)].insert(key, r.getId());
+    m_requestsByProviderStatus[qMakePair(r.getProviderId(), status)].insert(key, r.getId());
+}
+
+void DataManager::unindexRequest(const Request& r)
+{
+    const qint64 key = requestCreatedKey(r);
+    const int status = r.getStatusIndex();
+    m_requestsByCreatedAt.remove(key, r.getId());
+    removeFromIndex(m_requestsByClient, r.getClientId(), key, r.getId());
+    removeFromIndex(m_requestsByProvider, r.getProviderId(), key, r.getId());
+    removeFromIndex(m_requestsByService, r.getServiceId(), key, r.getId());
+    removeFromIndex(m_requestsByStatus, status, key, r.getId());
+    removeFromIndex(m_requestsByClientStatus, qMakePair(r.getClientId(), status), key, r.getId());
+    removeFromIndex(m_requestsByProviderStatus, qMakePair(r.getProviderId(), status), key, r.getId());
+}
+
+void DataManager::rebuildRequestIndexes()
+{
+    m_requestsByCreatedAt.clear();
+    m_requestsByClient.clear();
+    m_requestsByProvider.clear();
+    m_requestsByService.clear();
+    m_requestsByStatus.clear();
+    m_requestsByClientStatus.clear();
+    m_requestsByProviderStatus.clear();
     for (const auto& r : m_requests)
-        arr.append(r.toJson());
+        indexRequest(r);
+}
 
-    QFile f(requestsFilePath());
-    if (!f.open(QIODevice::WriteOnly)) return;
+typedef QVector<const RankIndex<qint64>*> RequestSources;
 
-    const QJsonDocument doc(arr);
-    f.write(doc.toJson(QJsonDocument::Indented));
+static int sourcesSize(const RequestSources& sources)
+{
+    int n = 0;
+    for (const auto* index : sources)
+        n += index->size();
+    return n;
 }
 
-QVariantList DataManager::requestsToVariantList(const QVector<Request>& v)
+// индексы статусов из маски: общие или составные (participant, статус)
+static RequestSources statusSources(const QHash<int, RankIndex<qint64>>& byStatus, int statusMask)
 {
-    QVariantList out;
-    out.reserve(v.size());
-    for (const auto& r : v)
-        out.append(r.toJson().toVariantMap());
+    RequestSources out;
+    for (auto it = byStatus.constBegin(); it != byStatus.constEnd(); ++it) {
+        if (statusMask & RequestQuery::statusBit(it.key())) out.append(&it.value());
+    }
     return out;
 }
 
-int DataManager::indexOfRequest(const QUuid& id) const
+static RequestSources statusSources(const QHash<QPair<QUuid, int>, RankIndex<qint64>>& byStatus,
+                                                 const QUuid& participant, int statusMask)
+{
+    RequestSources out;
+    for (int bit = statusMask, status = 0; bit != 0; bit >>= 1, ++status) {
+        if (!(bit & 1)) continue;
+        const auto it = byStatus.constFind(qMakePair(participant, status));
+        if (it != byStatus.constEnd()) out.append(&it.value());
+    }
+    return out;
+}
+
+// самый короткий набор индексов, задействованных запросом: один индекс по id,
+// или объединение индексов статусов (общих либо составных с участником).
+// Остальные условия проверяются по записи при обходе
+QVector<const RankIndex<qint64>*> DataManager::requestSources(const RequestQuery& q) const
+{
+    RequestSources best{ &m_requestsByCreatedAt };
+    int bestSize = m_requestsByCreatedAt.size();
+
+    const QUuid keys[] = { q.clientId, q.providerId, q.serviceId };
+    const QHash<QUuid, RankIndex<qint64>>* indexes[] = {
+        &m_requestsByClient, &m_requestsByProvider, &m_requestsByService
+    };
+    for (int i = 0; i < 3; ++i) {
+        if (keys[i].isNull()) continue;
+        const auto it = indexes[i]->constFind(keys[i]);
+        if (it == indexes[i]->constEnd()) return RequestSources();
+        if (it.value().size() < bestSize) {
+            best = RequestSources{ &it.value() };
+            bestSize = it.value().size();
+        }
+    }
+    if (q.statusMask == 0) return best;
+
+    RequestSources candidates[] = {
+        statusSources(m_requestsByStatus, q.statusMask),
+        q.clientId.isNull() ? best : statusSources(m_requestsByClientStatus, q.clientId, q.statusMask),
+        q.providerId.isNull() ? best : statusSources(m_requestsByProviderStatus, q.providerId, q.statusMask)
+    };
+    for (const auto& c : candidates) {
+        const int n = sourcesSize(c);
+        if (n < bestSize) {
+            best = c;
+            bestSize = n;
+        }
+    }
+    return bestSize == 0 ? RequestSources() : best;
+}
+
+// слияние источников по убыванию (createdAt, id), каждый — с курсора
+QVector<QUuid> DataManager::queryRequestIds(const RequestQuery& q) const
+{
+    typedef RankIndex<qint64>::const_iterator Iter;
+    const RequestSources sources = requestSources(q);
+
+    QVector<Iter> pos;
+    pos.reserve(sources.size());
+    for (const auto* index : sources)
+        pos.append(q.hasAfter ? index->lowerBound(q.afterKey, q.afterId) : index->end());
+
+    QVector<QUuid> out;
+    while (q.limit < 0 || out.size() < q.limit) {
+        int next = -1;
+        QPair<qint64, QUuid> nextKey;
+        for (int i = 0; i < pos.size(); ++i) {
+            if (pos[i] == sources[i]->begin()) continue;
+            Iter prev = pos[i];
+            --prev;
+            if (next < 0 || nextKey < prev.key()) {
+                next = i;
+                nextKey = prev.key();
+            }
+        }
+        if (next < 0) break;
+
+        --pos[next];
+        const Request* r = findRequest(nextKey.second);
+        if (!r || !q.matches(*r)) continue;
+        out.append(nextKey.second);
+    }
+    return out;
+}
+
+QVariantList DataManager::getAllRequests(int limit, const QString& after) const
 {
-    for (int i = 0; i < m_requests.size(); ++i)
-        if (m_requests[i].getId() == id) return i;
-    return -1;
+    return requestsPage(m_requests, m_conversations, m_requestIndex, m_requestsByCreatedAt, limit, after);
 }
 
-QVariantList DataManager::getAllRequests() const
+QVariantList DataManager::queryRequests(const QVariantMap& spec) const
 {
-    return requestsToVariantList(m_requests);
+    RequestQuery q = RequestQuery::fromVariantMap(spec);
+
+    const QString mine = spec.value("mine").toString();
+    if (!mine.isEmpty()) {
+        if (!m_loggedIn) return QVariantList();
+        if (mine == "client") q.clientId = m_currentUser.id;
+        else if (mine == "provider") q.providerId = m_currentUser.id;
+    }
+
+    double afterKey = 0.0;
+    q.hasAfter = parseCursorToken(spec.value("after").toString(), &afterKey, &q.afterId);
+    q.afterKey = qint64(afterKey);
+
+    const QVector<QUuid> ids = queryRequestIds(q);
+
+    QVariantList out;
+    out.reserve(ids.size());
+    for (const auto& id : ids) {
+        const Request& r = m_requests[indexOfRequest(id)];
+        QVariantMap row = r.toJson().toVariantMap();
+        addCommentSummary(row, m_conversations, id);
+        row["cursor"] = cursorToken(double(requestCreatedKey(r)), id);
+        out.append(row);
+    }
+    return out;
 }
 
 QString DataManager::createRequest(const QString& serviceId,
                                    const QString& providerId,
                                    const QString& description)
 {
+    if (!storeLoaded(RequestsStore)) return QString();
     if (!m_loggedIn) return QString();
 
     QUuid sid(serviceId.trimmed());
@@ -491,8 +1603,14 @@ QString DataManager::createRequest(const QString& serviceId,
     Request r(QUuid::createUuid(), sid, m_currentUser.id, pid);
     r.setDescription(description);
 
-    m_requests.append(r);
-    saveRequests();
+    m_requestIndex.append(m_requests, r, requestKey);
+    indexRequest(r);
+
+    QJsonObject op = requestOp("create", r.getId());
+    op["request"] = r.toJson();
+    logRequestOp(op);
+
+    emit requestAdded(r.getId());
     emit requestsChanged();
 
     return r.getId().toString(QUuid::WithoutBraces);
@@ -500,20 +1618,28 @@ QString DataManager::createRequest(const QString& serviceId,
 
 bool DataManager::deleteRequest(const QString& requestId)
 {
+    if (!storeLoaded(RequestsStore)) return false;
+
     const QUuid rid(requestId.trimmed());
     if (rid.isNull()) return false;
 
     const int idx = indexOfRequest(rid);
     if (idx < 0) return false;
 
-    m_requests.removeAt(idx);
-    saveRequests();
+    unindexRequest(m_requests[idx]);
+    m_requestIndex.removeAt(m_requests, idx, requestKey);
+    logRequestOp(requestOp("delete", rid));
+    // комментарии уходят вместе с беседой; беседы ещё не загружены — сирота отбросится при их загрузке
+    if (storeLoaded(ConversationsStore)) dropConversation(rid);
+    emit requestRemoved(rid);
     emit requestsChanged();
     return true;
 }
 
 bool DataManager::updateRequestStatus(const QString& requestId, int statusIndex)
 {
+    if (!storeLoaded(RequestsStore)) return false;
+
     if (statusIndex < 0) statusIndex = 0;
     if (statusIndex > 4) statusIndex = 4;
 
@@ -537,14 +1663,26 @@ bool DataManager::updateRequestStatus(const QString& requestId, int statusIndex)
 
     if (idx < 0) return false;
 
-    m_requests[idx].setStatusFromInt(statusIndex);
-    saveRequests();
+    Request& r = m_requests[idx];
+    // статус — единственное индексируемое поле, которое меняется у живой заявки
+    unindexRequest(r);
+    r.setStatusFromInt(statusIndex);
+    indexRequest(r);
+
+    QJsonObject op = requestOp("status", r.getId());
+    op["status"] = r.getStatusIndex();
+    op["completedAt"] = r.getCompletedAt().isValid() ? r.getCompletedAt().toString(Qt::ISODate) : QString();
+    logRequestOp(op);
+
+    emit requestUpdated(r.getId());
     emit requestsChanged();
     return true;
 }
 
 bool DataManager::updateRequestDescription(const QString& requestId, const QString& description)
 {
+    if (!storeLoaded(RequestsStore)) return false;
+
     const QUuid rid(requestId.trimmed());
     if (rid.isNull()) return false;
 
@@ -552,76 +1690,275 @@ bool DataManager::updateRequestDescription(const QString& requestId, const QStri
     if (idx < 0) return false;
 
     m_requests[idx].setDescription(description);
-    saveRequests();
+
+    QJsonObject op = requestOp("description", rid);
+    op["description"] = m_requests[idx].getDescription();
+    logRequestOp(op);
+
+    emit requestUpdated(rid);
     emit requestsChanged();
     return true;
 }
 
+const Message* DataManager::lastComment(const QUuid& requestId) const
+{
+    return m_conversations.lastMessage(requestId);
+}
+
+int DataManager::commentCount(const QUuid& requestId) const
+{
+    return m_conversations.messageCount(requestId);
+}
+
 bool DataManager::addRequestComment(const QString& requestId, const QString& comment)
 {
+    if (!storeLoaded(RequestsStore) || !storeLoaded(ConversationsStore)) return false;
+
     const QUuid rid(requestId.trimmed());
     if (rid.isNull()) return false;
 
     const QString c = comment.trimmed();
     if (c.isEmpty()) return false;
 
-    const int idx = indexOfRequest(rid);
-    if (idx < 0) return false;
+    const Request* r = findRequest(rid);
+    if (!r) return false;
 
-    m_requests[idx].addComment(c);
-    saveRequests();
+    // одна строка в файле беседы заявки; заявка и requests.journal не трогаются
+    return postMessage(*r, c);
+}
+
+// ---------------- Conversations ----------------
+void DataManager::saveConversations() const
+{
+    if (m_persistence) m_persistence->submitConversations(m_conversations);
+}
+
+void DataManager::logConversationOp(const QJsonObject& op)
+{
+    // номер — после изменения в памяти: снапшот, снятый следом, его уже учитывает
+    const QJsonObject stamped = m_conversations.stamp(op);
+    if (m_persistence) m_persistence->appendConversationOp(stamped);
+    if (++m_conversationOpsSinceCheckpoint >= kConversationsCheckpointEvery) {
+        saveConversations();
+        m_conversationOpsSinceCheckpoint = 0;
+    }
+}
+
+void DataManager::ensureConversation(const Request& r)
+{
+    const QUuid cid = r.getId();
+    if (m_conversations.contains(cid)) return;
+
+    const QVector<QUuid> participants{ r.getClientId(), r.getProviderId() };
+    m_conversations.ensure(cid, participants);
+    logConversationOp(ConversationStore::ensureOp(cid, participants));
+}
+
+// Перенос дописывает недостающие комментарии в конец беседы: в файлах, которые уже
+// есть, так оказываются лишь те, что разошлись с беседой из-за сбоя.
+// Старые источники воркер удаляет (comments.journal) и сворачивает (requests.json)
+// только после того, как строки бесед окажутся на диске
+void DataManager::migrateComments()
+{
+    if (!storeLoaded(RequestsStore) || !storeLoaded(ConversationsStore)) return;
+
+    for (auto it = m_unmigratedComments.constBegin(); it != m_unmigratedComments.constEnd(); ++it) {
+        const Request* r = findRequest(it.key());
+        if (!r) continue;
+
+        ensureConversation(*r);
+        // история уже была видна в заявке, поэтому непрочитанной не считается
+        for (const auto& m : it.value())
+            appendToConversation(it.key(), m, false);
+    }
+    m_unmigratedComments.clear();
+
+    if (!m_oldCommentSources) return;
+    m_oldCommentSources = false;
+    if (m_persistence) m_persistence->retireComments();
+    checkpointRequests(); // снапшот заявок без комментариев внутри
+}
+
+void DataManager::dropConversation(const QUuid& conversationId)
+{
+    if (!m_conversations.remove(conversationId)) return;
+    if (m_persistence) m_persistence->removeConversation(m_conversations.filePath(conversationId));
+    logConversationOp(ConversationStore::dropOp(conversationId));
+}
+
+void DataManager::dropOrphanConversations()
+{
+    if (!storeLoaded(RequestsStore) || !storeLoaded(ConversationsStore)) return;
+    // requests.json не прочитан (нет, битый) или пуст — сиротами выглядели бы все беседы;
+    // сбой загрузки не должен стоить переписки, поэтому чистка ждёт нормального старта
+    if (!m_requestsIntact) return;
+
+    const QList<QUuid> ids = m_conversations.ids();
+    for (const auto& id : ids) {
+        if (!findRequest(id)) dropConversation(id);
+    }
+}
+
+void DataManager::appendToConversation(const QUuid& conversationId, const Message& m, bool countUnread)
+{
+    const QJsonObject record = m_conversations.append(conversationId, m, countUnread);
+    if (m_persistence) m_persistence->appendMessage(m_conversations.filePath(conversationId), record);
+    logConversationOp(ConversationStore::addOp(conversationId, record, countUnread));
+}
+
+QVector<Message> DataManager::messagesBefore(const QUuid& conversationId, int limit, const QUuid& beforeId)
+{
+    if (!storeLoaded(ConversationsStore)) return QVector<Message>();
+
+    // беседа заявки, в которой ещё не писали: заводится при первом открытии
+    if (!m_conversations.contains(conversationId)) {
+        const Request* r = findRequest(conversationId);
+        if (!r) return QVector<Message>();
+        ensureConversation(*r);
+    }
+
+    // страница из файла: недописанные воркером строки этой беседы должны быть уже на диске;
+    // остальные хранилища ждут своего таймера
+    if (m_persistence && m_conversations.pageNeedsDisk(conversationId, limit, beforeId))
+        m_persistence->flushMessages(m_conversations.filePath(conversationId));
+    return m_conversations.page(conversationId, limit, beforeId);
+}
+
+const Message* DataManager::recentMessage(const QUuid& conversationId, int index) const
+{
+    return m_conversations.messageAt(conversationId, index);
+}
+
+bool DataManager::postMessage(const Request& r, const QString& text)
+{
+    const QUuid cid = r.getId();
+
+    // адресат — другая сторона заявки
+    const QUuid receiver = (m_currentUser.id == r.getClientId()) ? r.getProviderId() : r.getClientId();
+    const Message m(QUuid(), m_currentUser.id, receiver, text, QDateTime::currentDateTime());
+
+    ensureConversation(r);
+    // написать может и не участник заявки (например, администратор) — он становится участником
+    if (!m_currentUser.id.isNull() && m_currentUser.id != r.getClientId()
+        && m_currentUser.id != r.getProviderId()) {
+        m_conversations.ensure(cid, QVector<QUuid>{ m_currentUser.id });
+        logConversationOp(ConversationStore::ensureOp(cid, QVector<QUuid>{ m_currentUser.id }));
+    }
+    appendToConversation(cid, m, true);
+
+    emit commentAdded(cid.toString(QUuid::WithoutBraces), m_conversations.messageCount(cid) - 1);
+    emit unreadChanged(cid);
+    // commentCount / lastComment строки заявки
+    emit requestUpdated(cid);
     emit requestsChanged();
     return true;
 }
 
-// ---------------- Reviews storage ----------------
-void DataManager::loadReviews()
+bool DataManager::sendMessage(const QString& conversationId, const QString& text)
 {
-    QFile f(reviewsFilePath());
-    if (!f.open(QIODevice::ReadOnly)) return;
+    if (!storeLoaded(ConversationsStore) || !m_loggedIn) return false;
+
+    const QUuid cid(conversationId.trimmed());
+    const QString t = text.trimmed();
+    if (cid.isNull() || t.isEmpty()) return false;
 
-    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
-    if (!doc.isArray()) return;
+    const Request* r = findRequest(cid);
+    if (!r) return false;
 
-    m_reviews.clear();
-    const QJsonArray arr = doc.array();
-    m_reviews.reserve(arr.size());
+    return postMessage(*r, t);
+}
+
+QVariantList DataManager::getMessages(const QString& conversationId, int limit, const QString& beforeId)
+{
+    const QVector<Message> page = messagesBefore(QUuid(conversationId.trimmed()), limit,
+                                                 QUuid(beforeId.trimmed()));
 
-    for (const auto& v : arr) {
-        if (!v.isObject()) continue;
-        m_reviews.append(Review::fromJson(v.toObject()));
+    QVariantList out;
+    out.reserve(page.size());
+    for (const auto& m : page) {
+        QVariantMap row = m.toJson().toVariantMap();
+        row["isMe"] = m_loggedIn && m.getSenderId() == m_currentUser.id;
+        out.append(row);
     }
+    return out;
 }
 
-void DataManager::saveReviews() const
+int DataManager::getUnreadCount(const QString& conversationId) const
 {
-    QJsonArray arr;
-    for (const auto& r : m_reviews)
-        arr.append(r.toJson());
+    if (!m_loggedIn) return 0;
+    return m_conversations.unread(QUuid(conversationId.trimmed()), m_currentUser.id);
+}
+
+bool DataManager::markConversationRead(const QString& conversationId)
+{
+    if (!storeLoaded(ConversationsStore) || !m_loggedIn) return false;
+
+    const QUuid cid(conversationId.trimmed());
+    if (!m_conversations.markRead(cid, m_currentUser.id)) return false;
+
+    logConversationOp(ConversationStore::readOp(cid, m_currentUser.id));
+    emit unreadChanged(cid);
+    return true;
+}
 
-    QFile f(reviewsFilePath());
-    if (!f.open(QIODevice::WriteOnly)) return;
+// ---------------- Reviews storage ----------------
+void DataManager::saveReviews() const
+{
+    if (m_persistence) m_persistence->submitReviews(m_reviews);
+}
 
-    const QJsonDocument doc(arr);
-    f.write(doc.toJson(QJsonDocument::Indented));
+void DataManager::rebuildReviewIndexes()
+{
+    m_reviewIndex.rebuild(m_reviews, reviewKey);
+    m_reviewsByService.clear();
+    for (const auto& r : m_reviews)
+        m_reviewsByService[r.getServiceId()].insert(reviewCreatedKey(r), r.getId());
 }
 
-QVariantList DataManager::getReviewsForService(const QString& serviceId) const
+const Review* DataManager::findReview(const QUuid& id) const
 {
-    QVariantList out;
+    const int idx = m_reviewIndex.slotOf(id);
+    return idx >= 0 ? &m_reviews[idx] : nullptr;
+}
 
-    const QUuid sid(serviceId.trimmed());
-    if (sid.isNull()) return out;
+QVector<QUuid> DataManager::reviewIdsNewestFirst(const QUuid& serviceId, int limit, const QUuid& afterId) const
+{
+    QVector<QUuid> out;
+    const auto byService = m_reviewsByService.constFind(serviceId);
+    if (byService == m_reviewsByService.constEnd()) return out;
 
-    for (const auto& r : m_reviews) {
-        if (r.getServiceId() != sid) continue;
-        out.append(r.toJson().toVariantMap());
+    const RankIndex<qint64>& order = byService.value();
+    const Review* after = afterId.isNull() ? nullptr : findReview(afterId);
+    auto it = after ? order.lowerBound(reviewCreatedKey(*after), afterId) : order.end();
+    while (it != order.begin() && (limit < 0 || out.size() < limit)) {
+        --it;
+        out.append(it.key().second);
     }
     return out;
 }
 
+QVariantList DataManager::getReviewsForService(const QString& serviceId,
+                                               int limit, const QString& after) const
+{
+    const QUuid sid(serviceId.trimmed());
+    if (sid.isNull()) return QVariantList();
+
+    // только отзывы этой услуги, без прохода по всем отзывам
+    const auto it = m_reviewsByService.constFind(sid);
+    if (it == m_reviewsByService.constEnd()) return QVariantList();
+
+    return newestFirstPage(m_reviews, m_reviewIndex, it.value(), limit, after);
+}
+
+int DataManager::getReviewCount(const QString& serviceId) const
+{
+    const auto it = m_reviewsByService.constFind(QUuid(serviceId.trimmed()));
+    return it == m_reviewsByService.constEnd() ? 0 : it.value().size();
+}
+
 bool DataManager::addReview(const QString& serviceId, int rating, const QString& comment)
 {
+    if (!storeLoaded(ReviewsStore)) return false;
     if (!m_loggedIn) return false;
 
     const QUuid sid(serviceId.trimmed());
@@ -634,74 +1971,91 @@ bool DataManager::addReview(const QString& serviceId, int rating, const QString&
     if (r < 1) r = 1;
     if (r > 5) r = 5;
 
-    m_reviews.append(Review(QUuid::createUuid(), m_currentUser.id, sid, double(r), c));
+    const Review review(QUuid::createUuid(), m_currentUser.id, sid, double(r), c);
+    m_reviewIndex.append(m_reviews, review, reviewKey);
+    m_reviewsByService[sid].insert(reviewCreatedKey(review), review.getId());
+
+    // сводки обновляются одним отзывом, без пересчёта по m_reviews
+    RatingAggregate& agg = m_serviceRatings[sid];
+    agg.add(review.getRating());
+
     saveReviews();
+    emit reviewAdded(review.getId());
     emit reviewsChanged();
+
+    const Service* s = m_catalog.findService(sid);
+    if (s) {
+        m_providerRatings[s->getProviderId()].add(review.getRating());
+        // рейтинг производный и пересчитывается при загрузке: services.bin не переписывается
+        m_catalog.setServiceRating(sid, agg.score());
+        emit serviceUpdated(sid);
+        emit servicesChanged();
+    }
     return true;
 }
 
-// ---------------- Subscription storage ----------------
-void DataManager::loadSubscriptions()
+// ---------------- Rating aggregates ----------------
+void DataManager::rebuildServiceRatings()
 {
-    QFile f(subscriptionsFilePath());
-    if (!f.open(QIODevice::ReadOnly)) return;
-
-    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
-    if (!doc.isArray()) return;
+    m_serviceRatings.clear();
+    for (const auto& r : m_reviews)
+        m_serviceRatings[r.getServiceId()].add(r.getRating());
+}
 
-    m_subscriptions.clear();
-    const QJsonArray arr = doc.array();
-    m_subscriptions.reserve(arr.size());
+// рейтинг услуги с отзывами = score её сводки; у услуги без отзывов остаётся
+// рейтинг из каталога. Сводки исполнителей — по каталогу
+void DataManager::applyRatingsToCatalog()
+{
+    if (!storeLoaded(ServicesStore) || !storeLoaded(ReviewsStore)) return;
 
-    for (const auto& v : arr) {
-        if (!v.isObject()) continue;
-        m_subscriptions.append(Subscription::fromJson(v.toObject()));
+    m_providerRatings.clear();
+    for (auto it = m_serviceRatings.constBegin(); it != m_serviceRatings.constEnd(); ++it) {
+        const Service* s = m_catalog.findService(it.key());
+        if (!s) continue;
+        m_catalog.setServiceRating(it.key(), it.value().score());
+        m_providerRatings[s->getProviderId()].merge(it.value());
     }
 }
 
-void DataManager::saveSubscriptions() const
+// после add/update/delete услуги: рейтинг из отзывов важнее пришедшего из редактора
+// (без отзывов остаётся тот, что пришёл), а сводка отзывов переезжает к новому исполнителю
+void DataManager::syncServiceRating(const QUuid& serviceId, const QUuid& oldProviderId)
 {
-    QJsonArray arr;
-    for (const auto& s : m_subscriptions)
-        arr.append(s.toJson());
+    if (!storeLoaded(ReviewsStore)) return; // applyRatingsToCatalog при загрузке отзывов
+
+    const auto it = m_serviceRatings.constFind(serviceId);
+    if (it == m_serviceRatings.constEnd()) return;
 
-    QFile f(subscriptionsFilePath());
-    if (!f.open(QIODevice::WriteOnly)) return;
+    const Service* s = m_catalog.findService(serviceId);
+    const QUuid newProviderId = s ? s->getProviderId() : QUuid();
+    if (oldProviderId != newProviderId) {
+        if (!oldProviderId.isNull()) m_providerRatings[oldProviderId].subtract(it.value());
+        if (!newProviderId.isNull()) m_providerRatings[newProviderId].merge(it.value());
+    }
 
-    const QJsonDocument doc(arr);
-    f.write(doc.toJson(QJsonDocument::Indented));
+    if (s) m_catalog.setServiceRating(serviceId, it.value().score());
 }
 
-// ---------------- Favorites storage ----------------
-void DataManager::loadFavorites()
+QVariantMap DataManager::getServiceRating(const QString& serviceId) const
 {
-    QFile f(favoritesFilePath());
-    if (!f.open(QIODevice::ReadOnly)) return;
-
-    const QJsonDocument doc = QJsonDocument::fromJson(f.readAll());
-    if (!doc.isArray()) return;
+    return m_serviceRatings.value(QUuid(serviceId.trimmed())).toVariantMap();
+}
 
-    m_favorites.clear();
-    const QJsonArray arr = doc.array();
-    m_favorites.reserve(arr.size());
+QVariantMap DataManager::getProviderRating(const QString& providerId) const
+{
+    return m_providerRatings.value(QUuid(providerId.trimmed())).toVariantMap();
+}
 
-    for (const auto& v : arr) {
-        if (!v.isObject()) continue;
-        m_favorites.append(Favorites::fromJson(v.toObject()));
-    }
+// ---------------- Subscription storage ----------------
+void DataManager::saveSubscriptions() const
+{
+    if (m_persistence) m_persistence->submitSubscriptions(m_subscriptions);
 }
 
+// ---------------- Favorites storage ----------------
 void DataManager::saveFavorites() const
 {
-    QJsonArray arr;
-    for (const auto& fav : m_favorites)
-        arr.append(fav.toJson());
-
-    QFile f(favoritesFilePath());
-    if (!f.open(QIODevice::WriteOnly)) return;
-
-    const QJsonDocument doc(arr);
-    f.write(doc.toJson(QJsonDocument::Indented));
+    if (m_persistence) m_persistence->submitFavorites(m_favorites);
 }
 
 // ---------------- Subscription API ----------------
@@ -710,7 +2064,7 @@ QVariantMap DataManager::getMySubscription() const
     QVariantMap out;
     if (!m_loggedIn) return out;
 
-    const int idx = indexOfSubscriptionByUser(m_subscriptions, m_currentUser.id);
+    const int idx = m_subscriptionIndex.slotOf(m_currentUser.id);
     if (idx < 0) return out;
 
     const Subscription& s = m_subscriptions[idx];
@@ -732,12 +2086,13 @@ bool DataManager::saveMySubscription(const QString& planType,
                                      const QString& endIso,
                                      bool active)
 {
+    if (!storeLoaded(SubscriptionsStore)) return false;
     if (!m_loggedIn) return false;
 
     const QDateTime dtStart = parseIsoMaybeDateOnly(startIso);
     const QDateTime dtEnd = parseIsoMaybeDateOnly(endIso);
 
-    int idx = indexOfSubscriptionByUser(m_subscriptions, m_currentUser.id);
+    int idx = m_subscriptionIndex.slotOf(m_currentUser.id);
 
     if (idx < 0) {
         Subscription s(QUuid::createUuid(), m_currentUser.id);
@@ -748,7 +2103,7 @@ bool DataManager::saveMySubscription(const QString& planType,
         s.setActive(active);
 
         if (!s.isValid()) return false;
-        m_subscriptions.append(s);
+        m_subscriptionIndex.append(m_subscriptions, s, subscriptionUserKey);
     } else {
         Subscription& s = m_subscriptions[idx];
         s.setPlanType(planType);
@@ -767,9 +2122,10 @@ bool DataManager::saveMySubscription(const QString& planType,
 
 bool DataManager::cancelMySubscription()
 {
+    if (!storeLoaded(SubscriptionsStore)) return false;
     if (!m_loggedIn) return false;
 
-    const int idx = indexOfSubscriptionByUser(m_subscriptions, m_currentUser.id);
+    const int idx = m_subscriptionIndex.slotOf(m_currentUser.id);
     if (idx < 0) return false;
 
     m_subscriptions[idx].cancel();
@@ -780,12 +2136,20 @@ bool DataManager::cancelMySubscription()
 }
 
 // ---------------- Favorites API ----------------
+Favorites& DataManager::ensureFavoritesForUser(const QUuid& uid)
+{
+    int idx = m_favoritesIndex.slotOf(uid);
+    if (idx < 0)
+        idx = m_favoritesIndex.append(m_favorites, Favorites(QUuid::createUuid(), uid), favoritesUserKey);
+    return m_favorites[idx];
+}
+
 QVariantMap DataManager::getMyFavorites() const
 {
     QVariantMap out;
     if (!m_loggedIn) return out;
 
-    const int idx = indexOfFavoritesByUser(m_favorites, m_currentUser.id);
+    const int idx = m_favoritesIndex.slotOf(m_currentUser.id);
     if (idx < 0) return out;
 
     const Favorites& f = m_favorites[idx];
@@ -816,12 +2180,13 @@ QVariantMap DataManager::getMyFavorites() const
 
 bool DataManager::toggleFavoriteService(const QString& serviceId)
 {
+    if (!storeLoaded(FavoritesStore)) return false;
     if (!m_loggedIn) return false;
 
     const QUuid sid(serviceId.trimmed());
     if (sid.isNull()) return false;
 
-    Favorites& f = ensureFavoritesForUser(m_favorites, m_currentUser.id);
+    Favorites& f = ensureFavoritesForUser(m_currentUser.id);
     f.toggleFavoriteService(sid);
 
     saveFavorites();
@@ -831,12 +2196,13 @@ bool DataManager::toggleFavoriteService(const QString& serviceId)
 
 bool DataManager::toggleFavoriteProvider(const QString& providerId)
 {
+    if (!storeLoaded(FavoritesStore)) return false;
     if (!m_loggedIn) return false;
 
     const QUuid pid(providerId.trimmed());
     if (pid.isNull()) return false;
 
-    Favorites& f = ensureFavoritesForUser(m_favorites, m_currentUser.id);
+    Favorites& f = ensureFavoritesForUser(m_currentUser.id);
     f.toggleFavoriteProvider(pid);
 
     saveFavorites();
@@ -846,12 +2212,13 @@ bool DataManager::toggleFavoriteProvider(const QString& providerId)
 
 bool DataManager::addViewedService(const QString& serviceId)
 {
+    if (!storeLoaded(FavoritesStore)) return false;
     if (!m_loggedIn) return false;
 
     const QUuid sid(serviceId.trimmed());
     if (sid.isNull()) return false;
 
-    Favorites& f = ensureFavoritesForUser(m_favorites, m_currentUser.id);
+    Favorites& f = ensureFavoritesForUser(m_currentUser.id);
     f.addViewedService(sid, 50);
 
     saveFavorites();
@@ -861,9 +2228,10 @@ bool DataManager::addViewedService(const QString& serviceId)
 
 bool DataManager::clearMyViewHistory()
 {
+    if (!storeLoaded(FavoritesStore)) return false;
     if (!m_loggedIn) return false;
 
-    Favorites& f = ensureFavoritesForUser(m_favorites, m_currentUser.id);
+    Favorites& f = ensureFavoritesForUser(m_currentUser.id);
     f.clearViewHistory();
 
     saveFavorites();
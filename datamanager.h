@@ -9,13 +9,25 @@
 #include <QVariantMap>
 #include <QUuid>
 #include <QDateTime>
+#include <QThread>
+#include <QElapsedTimer>
 
 #include "catalog.h"
 #include "profile.h"
 #include "request.h"
+#include "requestquery.h"
 #include "subscription.h"
 #include "favorites.h"
 #include "review.h"
+#include "idindex.h"
+#include "rankindex.h"
+#include "ratingaggregate.h"
+#include "userstore.h"
+#include "asyncreply.h"
+#include "conversationstore.h"
+
+class PersistenceWorker;
+class QFutureWatcherBase;
 
 class DataManager : public QObject
 {
@@ -28,9 +40,17 @@ class DataManager : public QObject
     Q_PROPERTY(QString currentUserPhone READ currentUserPhone NOTIFY currentUserChanged)
     Q_PROPERTY(QString currentUserRole READ currentUserRole NOTIFY currentUserChanged)
     Q_PROPERTY(bool currentUserVerified READ currentUserVerified NOTIFY currentUserChanged)
+    Q_PROPERTY(bool authBusy READ authBusy NOTIFY authBusyChanged) // идёт хеширование пароля
+
+    // --- startup loading ---
+    Q_PROPERTY(bool ready READ ready NOTIFY readyChanged)
+    Q_PROPERTY(double loadingProgress READ loadingProgress NOTIFY loadingProgressChanged)
+
+    Q_PROPERTY(int serviceCount READ serviceCount NOTIFY servicesChanged)
 
 public:
     explicit DataManager(QObject* parent = nullptr);
+    ~DataManager() override;
     static DataManager& instance();
 
     // --- properties getters ---
@@ -40,8 +60,28 @@ public:
     QString currentUserPhone() const { return m_currentUser.phone; }
     QString currentUserRole() const;
     bool currentUserVerified() const { return m_currentUser.verified; }
+    bool authBusy() const { return m_authBusy; }
+
+    bool ready() const { return m_loadedStores == AllStores; }
+    double loadingProgress() const; // 0..1, доля загруженных хранилищ
+
+    int serviceCount() const { return m_catalog.serviceCount(); }
+
+    // фоновая загрузка хранилищ; каждое доступно сразу по готовности (*Changed)
+    void startLoading();
 
     // ---------------- Auth/User ----------------
+    // Хеш пароля (PBKDF2) считается сотни миллисекунд. *Async-варианты считают его
+    // в пуле потоков и отвечают сигналами *Finished; пока идёт одна операция,
+    // следующая сразу получает false. Первая операция сначала читает пользователей
+    // в фоне и продолжается по готовности. Синхронные версии блокируют вызывающий поток.
+    Q_INVOKABLE void registerUserAsync(const QString& email,
+                                       const QString& phone,
+                                       int roleIndex,
+                                       const QString& password);
+    Q_INVOKABLE void loginAsync(const QString& emailOrPhone, const QString& password);
+    Q_INVOKABLE void changePasswordAsync(const QString& oldPass, const QString& newPass);
+
     Q_INVOKABLE bool registerUser(const QString& email,
                                   const QString& phone,
                                   int roleIndex,
@@ -64,28 +104,66 @@ public:
                                    const QString& contactPhone);
 
     // ---------------- Services/Catalog ----------------
-    Q_INVOKABLE QVariantList getAllServices() const;
+    const Catalog& catalog() const { return m_catalog; }
+
+    Q_INVOKABLE QString newServiceId() const;
+    Q_INVOKABLE QVariantMap getService(const QString& serviceId) const; // пустая map, если нет
+    // Постраничные списки: limit >= 0 или непустой after включают keyset-пагинацию
+    // (по умолчанию — от новых к старым); в каждой строке есть "cursor",
+    // который передаётся как after для следующей страницы.
+    Q_INVOKABLE QVariantList getAllServices(int limit = -1, const QString& after = QString()) const;
 
     Q_INVOKABLE bool addService(const QVariantMap& serviceMap);
     Q_INVOKABLE bool updateService(const QVariantMap& serviceMap);
     Q_INVOKABLE bool deleteService(const QString& serviceId);
 
+    // JSON импорт/экспорт каталога (хранится он в бинарном services.bin);
+    // пустой путь = services.json в каталоге данных
+    Q_INVOKABLE bool exportCatalogJson(const QString& path = QString()) const;
+    Q_INVOKABLE bool importCatalogJson(const QString& path = QString());
+
     // Catalog wrappers
-    Q_INVOKABLE QVariantList catalogGetActiveServices() const;
+    Q_INVOKABLE QVariantList catalogGetActiveServices(int limit = -1, const QString& after = QString()) const;
     Q_INVOKABLE QVariantList catalogSearchByName(const QString& name);
     Q_INVOKABLE QVariantList catalogSearchByDescription(const QString& text);
-    Q_INVOKABLE QVariantList catalogFilterByCategory(const QString& category) const;
-    Q_INVOKABLE QVariantList catalogFilterByPrice(double minPrice, double maxPrice) const;
-    Q_INVOKABLE QVariantList catalogFilterByRating(double minRating) const;
+    Q_INVOKABLE QVariantList catalogSearchByWords(const QString& query);
+    // все фильтры одним вызовом: {text, category, minPrice, maxPrice, minRating,
+    // activeOnly, sort: "rating"|"newest"|"priceAsc"|"priceDesc", limit, after}
+    Q_INVOKABLE QVariantList catalogQuery(const QVariantMap& spec) const;
+    Q_INVOKABLE QVariantList catalogFilterByCategory(const QString& category,
+                                                     int limit = -1, const QString& after = QString()) const;
+    Q_INVOKABLE QVariantList catalogFilterByPrice(double minPrice, double maxPrice,
+                                                  int limit = -1, const QString& after = QString()) const;
+    Q_INVOKABLE QVariantList catalogFilterByRating(double minRating,
+                                                   int limit = -1, const QString& after = QString()) const;
     Q_INVOKABLE QVariantList catalogGetPopularServices(int count) const;
     Q_INVOKABLE QVariantList catalogGetNewServices(int count) const;
     Q_INVOKABLE QStringList catalogGetCategories() const;
     Q_INVOKABLE QStringList catalogGetSearchHistory() const;
+    Q_INVOKABLE void catalogAddSearchHistory(const QString& query);
     Q_INVOKABLE QString catalogGetInfo() const;
     Q_INVOKABLE QString catalogGetFullInfo() const;
 
+    // Асинхронные варианты тяжёлых вызовов: работают в пуле потоков над снапшотом
+    // (копия implicitly shared контейнеров — O(1)), результат приходит в
+    // AsyncReply::finished. Синхронные версии выше считают то же самое на месте.
+    Q_INVOKABLE AsyncReply* catalogQueryAsync(const QVariantMap& spec) const;
+    Q_INVOKABLE AsyncReply* getAllRequestsAsync(int limit = -1, const QString& after = QString()) const;
+    Q_INVOKABLE AsyncReply* exportCatalogJsonAsync(const QString& path = QString()) const;   // finished(bool)
+    // разбор файла и сборка индексов — в пуле, замена каталога — в GUI-потоке
+    Q_INVOKABLE AsyncReply* importCatalogJsonAsync(const QString& path = QString());       // finished(bool)
+
     // ---------------- Requests ----------------
-    Q_INVOKABLE QVariantList getAllRequests() const;
+    // для RequestListModel: указатель действителен до следующего изменения заявок
+    const Request* findRequest(const QUuid& id) const;
+    // id заявок от новых к старым; обходит самый узкий из вторичных индексов запроса
+    QVector<QUuid> queryRequestIds(const RequestQuery& q) const;
+
+    Q_INVOKABLE QVariantList getAllRequests(int limit = -1, const QString& after = QString()) const;
+    // формат spec — RequestQuery::fromVariantMap, плюс mine: "client"|"provider" (текущий
+    // пользователь) и after — cursor последней строки прошлой страницы.
+    // Например, мои открытые заявки как исполнителя: {mine: "provider", open: true}
+    Q_INVOKABLE QVariantList queryRequests(const QVariantMap& spec) const;
 
     Q_INVOKABLE QString createRequest(const QString& serviceId,
                                       const QString& providerId,
@@ -96,8 +174,37 @@ public:
     Q_INVOKABLE bool updateRequestDescription(const QString& requestId, const QString& description);
     Q_INVOKABLE bool addRequestComment(const QString& requestId, const QString& comment);
 
+    // комментарий заявки — сообщение её беседы (то же, что sendMessage, но без входа в систему);
+    // в строках заявок только commentCount и lastComment по всей беседе, история — в чате
+    const Message* lastComment(const QUuid& requestId) const;
+    int commentCount(const QUuid& requestId) const;
+
+    // ---------------- Conversations ----------------
+    // чат заявки между клиентом и исполнителем; id беседы = id заявки.
+    // для MessageListModel: страница от новых к старым строго до beforeId (нулевой — с последнего)
+    QVector<Message> messagesBefore(const QUuid& conversationId, int limit, const QUuid& beforeId = QUuid());
+    const Message* recentMessage(const QUuid& conversationId, int index) const; // nullptr — не в хвосте
+
+    Q_INVOKABLE bool sendMessage(const QString& conversationId, const QString& text);
+    // строки Message::toJson + isMe; beforeId — id последнего уже полученного сообщения
+    Q_INVOKABLE QVariantList getMessages(const QString& conversationId,
+                                         int limit = 50, const QString& beforeId = QString());
+    Q_INVOKABLE int getUnreadCount(const QString& conversationId) const; // для текущего пользователя
+    Q_INVOKABLE bool markConversationRead(const QString& conversationId);
+
     // ---------------- Reviews ----------------
-    Q_INVOKABLE QVariantList getReviewsForService(const QString& serviceId) const;
+    // для ReviewListModel: указатель действителен до следующего изменения отзывов
+    const Review* findReview(const QUuid& id) const;
+    // id отзывов услуги от новых к старым; afterId — последний уже полученный (нулевой — с начала)
+    QVector<QUuid> reviewIdsNewestFirst(const QUuid& serviceId, int limit, const QUuid& afterId = QUuid()) const;
+
+    // от новых к старым; limit/after — keyset-страницы, как у getAllRequests
+    Q_INVOKABLE QVariantList getReviewsForService(const QString& serviceId,
+                                                  int limit = -1, const QString& after = QString()) const;
+    Q_INVOKABLE int getReviewCount(const QString& serviceId) const;
+    // {count, sum, mean, score, histogram: [1★..5★]}; score — байесовский, он же рейтинг услуги
+    Q_INVOKABLE QVariantMap getServiceRating(const QString& serviceId) const;
+    Q_INVOKABLE QVariantMap getProviderRating(const QString& providerId) const;
     Q_INVOKABLE bool addReview(const QString& serviceId, int rating, const QString& comment);
 
     // ---------------- Subscription ----------------
@@ -118,68 +225,193 @@ public:
     Q_INVOKABLE bool addViewedService(const QString& serviceId);
     Q_INVOKABLE bool clearMyViewHistory();
 
+    // ---------------- Persistence ----------------
+    // записи идут в фоне; flush() дожидается записи всего накопленного
+    Q_INVOKABLE void flush();
+
+    // время загрузки каждого хранилища при старте, мс: {services, requests, ..., total};
+    // total появляется, когда загружено всё
+    Q_INVOKABLE QVariantMap loadReport() const { return m_loadReport; }
+
+public slots:
+    void shutdown(); // flush + остановка потока записи (QCoreApplication::aboutToQuit)
+
 signals:
     void loggedInChanged();
     void currentUserChanged();
+    void authBusyChanged();
+    void registerFinished(bool ok);
+    void loginFinished(bool ok);
+    void passwordChangeFinished(bool ok);
+
+    void readyChanged();
+    void loadingProgressChanged();
 
     void servicesChanged();
+    // точечные изменения каталога (для ServiceListModel); servicesReset — каталог заменён целиком
+    void serviceAdded(const QUuid& id);
+    void serviceUpdated(const QUuid& id);
+    void serviceRemoved(const QUuid& id);
+    void servicesReset();
     void requestsChanged();
+    void requestAdded(const QUuid& id);
+    void requestUpdated(const QUuid& id);
+    void requestRemoved(const QUuid& id);
+    void requestsReset();
+    // новое сообщение беседы (комментарий заявки); index — его номер в беседе
+    void commentAdded(const QString& requestId, int index);
+    void conversationsReset();
+    void unreadChanged(const QUuid& conversationId);
     void reviewsChanged();
+    void reviewAdded(const QUuid& id);
+    void reviewsReset();
     void subscriptionsChanged();
     void favoritesChanged();
 
+private slots:
+    void onServicesLoaded();
+    void onRequestsLoaded();
+    void onReviewsLoaded();
+    void onSubscriptionsLoaded();
+    void onFavoritesLoaded();
+    void onConversationsLoaded();
+    void onCatalogImported();
+    void onUsersLoaded();
+    void onKdfCalibrated();
+    void onRegisterHashed();
+    void onLoginHashed();
+    void onPasswordChangeHashed();
+
 private:
+    enum LoadedStore {
+        ServicesStore      = 0x01,
+        RequestsStore      = 0x02,
+        ReviewsStore       = 0x04,
+        SubscriptionsStore = 0x08,
+        FavoritesStore     = 0x10,
+        ConversationsStore = 0x20,
+        AllStores          = 0x3F
+    };
+
+    // мутации хранилища до его загрузки отклоняются: иначе загрузка их затрёт
+    bool storeLoaded(int store) const { return (m_loadedStores & store) != 0; }
+    void markStoreLoaded(int store, const QString& name, qint64 elapsedMs);
+
     // ---- storage helpers ----
-    void loadServices();
+    // save*() только отдают снапшот воркеру, запись на диск идёт в его потоке
     void saveServices() const;
-
-    void loadRequests();
     void saveRequests() const;
-
-    void loadReviews();
     void saveReviews() const;
-
-    void loadSubscriptions();
     void saveSubscriptions() const;
-
-    void loadFavorites();
     void saveFavorites() const;
-
-    // ---- conversion helpers ----
-    static QVariantList servicesToVariantList(const QVector<Service>& v);
-    static QVariantList requestsToVariantList(const QVector<Request>& v);
+    void saveConversations() const;
+    // conversations: как requests — счётчики и прочтения в журнал, снапшот на checkpoint
+    void logConversationOp(const QJsonObject& op);
+    // беседа заявки, заводится при первом сообщении или открытии чата
+    void ensureConversation(const Request& r);
+    void appendToConversation(const QUuid& conversationId, const Message& m, bool countUnread);
+    bool postMessage(const Request& r, const QString& text); // комментарий или сообщение чата
+    void migrateComments(); // комментарии старых форматов -> беседы, когда загружены оба хранилища
+    void dropConversation(const QUuid& conversationId);
+    void dropOrphanConversations(); // беседы удалённых заявок, когда загружены оба хранилища
+                                    // и заявки прочитаны без сбоя
+
+    // requests: мутации пишутся в журнал, снапшот переписывается только на checkpoint
+    void logRequestOp(const QJsonObject& op);
+    void checkpointRequests();
+
+    void rebuildReviewIndexes();
+    void rebuildServiceRatings();
+    void applyRatingsToCatalog();
+    void syncServiceRating(const QUuid& serviceId, const QUuid& oldProviderId);
 
     int indexOfRequest(const QUuid& id) const;
-    int findUserByEmailOrPhone(const QString& s) const;
-
-    static QString hashPasswordHex(const QString& pass);
-    static QString genCode6();
+    void indexRequest(const Request& r);
+    void unindexRequest(const Request& r);
+    void rebuildRequestIndexes();
+    // индексы, объединение которых покрывает выборку; пусто — выборка пуста
+    QVector<const RankIndex<qint64>*> requestSources(const RequestQuery& q) const;
+    Favorites& ensureFavoritesForUser(const QUuid& uid);
+
+    // users: грузятся лениво при первом логине/регистрации, мутации — в журнал.
+    // startUsersLoad читает их в пуле потоков, ensureUsersLoaded (синхронные вызовы) ждёт чтения
+    void startUsersLoad();
+    void ensureUsersLoaded();
+    void applyUsersLoad();
+    void saveUsers() const;
+    void logUserOp(const QJsonObject& op);
+    void checkpointUsers();
+    void storeCurrentUser(); // m_currentUser -> хранилище + журнал
+
+    // общее завершение синхронных и асинхронных auth-вызовов (после хеширования)
+    bool beginAuth();
+    void endAuth();
+    bool canRegister(const QString& email, const QString& phone, const QString& password) const;
+    // *Async после beginAuth и загрузки пользователей
+    void startRegister(const QString& email, const QString& phone, int roleIndex, const QString& password);
+    void startLogin(const QString& emailOrPhone, const QString& password);
+    bool finishRegister(const User& user, bool ok);
+    bool finishLogin(const User& user, bool ok, bool rehashed);
+    bool finishPasswordChange(const User& user, bool ok);
 
 private:
-    struct UserRec {
-        QUuid id;
-        QString email;
+    bool m_loggedIn = false;
+    User m_currentUser;            // копия записи из m_userStore; без входа id нулевой
+
+    UserStore m_userStore;         // пользователи и профили с индексами
+    bool m_usersLoaded = false;
+    QFutureWatcherBase* m_usersLoad = nullptr; // идёт чтение пользователей
+    // auth-операция, ждущая чтения пользователей
+    struct PendingAuth
+    {
+        enum Kind { None, Login, Register };
+        Kind kind = None;
+        QString login;          // email или телефон для входа, email для регистрации
         QString phone;
-        int roleIndex = 0; // 0=Client,1=Provider,2=Admin
-        QString passHashHex;
-        QDateTime createdAt;
-        bool verified = false;
-        QString verificationCode;
+        int roleIndex = 0;
+        QString password;
     };
-
-private:
-    bool m_loggedIn = false;
-    UserRec m_currentUser;
-
-    QVector<UserRec> m_users;      // demo users (in-memory)
-    QVector<Profile> m_profiles;   // demo profiles (in-memory)
+    PendingAuth m_pendingAuth;
+    int m_userOpsSinceCheckpoint = 0;
+    bool m_authBusy = false;
 
     Catalog m_catalog;
 
     QVector<Request> m_requests;
+    IdIndex m_requestIndex;        // id -> slot
+    RankIndex<qint64> m_requestsByCreatedAt; // порядок страниц getAllRequests
+    // вторичные индексы: ключ -> заявки по createdAt; пустые ключи удаляются
+    QHash<QUuid, RankIndex<qint64>> m_requestsByClient;
+    QHash<QUuid, RankIndex<qint64>> m_requestsByProvider;
+    QHash<QUuid, RankIndex<qint64>> m_requestsByService;
+    QHash<int, RankIndex<qint64>> m_requestsByStatus;
+    // (участник, статус): открытые заявки пользователя без обхода всей его истории
+    QHash<QPair<QUuid, int>, RankIndex<qint64>> m_requestsByClientStatus;
+    QHash<QPair<QUuid, int>, RankIndex<qint64>> m_requestsByProviderStatus;
+    int m_requestOpsSinceCheckpoint = 0;
+    bool m_requestsIntact = false; // снапшот заявок прочитан и не пуст: можно чистить сироты
+    ConversationStore m_conversations; // метаданные всех бесед + хвосты открытых (и комментарии заявок)
+    // комментарии старых форматов, которых ещё нет в беседах: ждут загрузки бесед
+    QHash<QUuid, QVector<Message>> m_unmigratedComments;
+    bool m_oldCommentSources = false; // comments.journal или комментарии внутри заявок ещё на диске
+    int m_conversationOpsSinceCheckpoint = 0;
     QVector<Review> m_reviews;
+    IdIndex m_reviewIndex;         // id -> slot
+    QHash<QUuid, RankIndex<qint64>> m_reviewsByService; // serviceId -> отзывы по createdAt
+    QHash<QUuid, RatingAggregate> m_serviceRatings;      // по отзывам, инкрементально
+    QHash<QUuid, RatingAggregate> m_providerRatings;
     QVector<Subscription> m_subscriptions;
+    IdIndex m_subscriptionIndex;   // userId -> slot
     QVector<Favorites> m_favorites;
+    IdIndex m_favoritesIndex;      // userId -> slot
+
+    bool m_loadingStarted = false;
+    int m_loadedStores = 0;
+    QElapsedTimer m_loadTimer;
+    QVariantMap m_loadReport;
+
+    QThread m_persistenceThread;
+    PersistenceWorker* m_persistence = nullptr;
 };
 
 #endif // DATAMANAGER_H
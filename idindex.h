@@ -0,0 +1,65 @@
+#ifndef IDINDEX_H
+#define IDINDEX_H
+
+#include <QHash>
+#include <QUuid>
+#include <QVector>
+
+// Индекс id -> позиция (slot) записи в QVector хранилища.
+// Поддерживается при вставке, удалении и загрузке, поэтому поиск одной записи — O(1).
+// Удаление сохраняет порядок записей в векторе: от него зависят списки без
+// явной сортировки (getAllServices, filterBy*, searchByName и т. п.).
+class IdIndex
+{
+public:
+    void clear() { m_slots.clear(); }
+    int size() const { return int(m_slots.size()); }
+
+    int slotOf(const QUuid& id) const { return id.isNull() ? -1 : m_slots.value(id, -1); }
+    bool contains(const QUuid& id) const { return !id.isNull() && m_slots.contains(id); }
+
+    void insert(const QUuid& id, int slot)
+    {
+        if (!id.isNull()) m_slots.insert(id, slot);
+    }
+
+    void remove(const QUuid& id) { m_slots.remove(id); }
+
+    // полная перестройка, например после загрузки хранилища
+    template <typename T, typename KeyFn>
+    void rebuild(const QVector<T>& items, KeyFn key)
+    {
+        m_slots.clear();
+        m_slots.reserve(items.size());
+        for (int i = 0; i < items.size(); ++i)
+            insert(key(items[i]), i);
+    }
+
+    // добавить запись в конец и зарегистрировать; возвращает её slot
+    template <typename T, typename KeyFn>
+    int append(QVector<T>& items, const T& item, KeyFn key)
+    {
+        items.append(item);
+        const int slot = int(items.size()) - 1;
+        insert(key(item), slot);
+        return slot;
+    }
+
+    // удалить запись со сдвигом хвоста; slot каждой следующей записи уменьшается на 1.
+    // O(n), но удаления редки, а порядок остаётся тем же, что до удаления
+    template <typename T, typename KeyFn>
+    void removeAt(QVector<T>& items, int slot, KeyFn key)
+    {
+        if (slot < 0 || slot >= items.size()) return;
+
+        remove(key(items[slot]));
+        items.remove(slot);
+        for (int i = slot; i < items.size(); ++i)
+            insert(key(items[i]), i);
+    }
+
+private:
+    QHash<QUuid, int> m_slots;
+};
+
+#endif // IDINDEX_H
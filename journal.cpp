@@ -0,0 +1,151 @@
+#include "journal.h"
+
+#include <QFile>
+#include <QSaveFile>
+#include <QJsonDocument>
+
+#include <algorithm>
+
+Journal::Journal(const QString& path)
+    : m_path(path)
+{
+}
+
+bool Journal::append(const QJsonObject& record)
+{
+    QVector<QJsonObject> one;
+    one.append(record);
+    return append(one);
+}
+
+static QByteArray encodeRecords(const QVector<QJsonObject>& records)
+{
+    QByteArray chunk;
+    for (const auto& r : records) {
+        chunk.append(QJsonDocument(r).toJson(QJsonDocument::Compact));
+        chunk.append('\n');
+    }
+    return chunk;
+}
+
+bool Journal::append(const QVector<QJsonObject>& records)
+{
+    if (m_path.isEmpty()) return false;
+    if (records.isEmpty()) return true;
+
+    const QByteArray chunk = encodeRecords(records);
+
+    QFile f(m_path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Append)) return false;
+    if (f.write(chunk) != chunk.size()) return false;
+    f.flush();
+    return true;
+}
+
+bool Journal::clear()
+{
+    if (m_path.isEmpty()) return false;
+
+    QFile f(m_path);
+    if (!f.exists()) return true;
+    return f.remove();
+}
+
+bool Journal::rewrite(const QVector<QJsonObject>& records)
+{
+    if (m_path.isEmpty()) return false;
+
+    const QByteArray chunk = encodeRecords(records);
+    QSaveFile f(m_path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+    f.write(chunk);
+    return f.commit(); // при ошибке записи commit не заменит старый файл
+}
+
+QVector<QJsonObject> Journal::readRecords(const QString& path)
+{
+    QVector<QJsonObject> out;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return out;
+
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine().trimmed();
+        if (line.isEmpty()) continue;
+
+        const QJsonDocument doc = QJsonDocument::fromJson(line);
+        if (!doc.isObject()) continue;
+        out.append(doc.object());
+    }
+    return out;
+}
+
+static bool parseRecord(const QByteArray& line, qint64 offset, Journal::Record* out)
+{
+    const QByteArray trimmed = line.trimmed();
+    if (trimmed.isEmpty()) return false;
+
+    const QJsonDocument doc = QJsonDocument::fromJson(trimmed);
+    if (!doc.isObject()) return false;
+
+    out->offset = offset;
+    out->object = doc.object();
+    return true;
+}
+
+QVector<Journal::Record> Journal::readRecordsBefore(const QString& path, qint64 end, int max)
+{
+    static const qint64 kChunk = 64 * 1024;
+
+    QVector<Record> out;
+    if (max <= 0) return out;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return out;
+
+    // buf — байты [pos, pos + buf.size()); cut — граница ещё не разобранной части
+    qint64 pos = qBound<qint64>(0, end, f.size());
+    QByteArray buf;
+    qsizetype cut = 0;
+
+    while (out.size() < max) {
+        // последняя строка заканчивается на '\n' в cut - 1; ищем конец предыдущей
+        const qsizetype nl = (cut >= 2) ? buf.lastIndexOf('\n', cut - 2) : -1;
+        if (nl >= 0) {
+            Record r;
+            if (parseRecord(buf.mid(nl + 1, cut - nl - 1), pos + nl + 1, &r)) out.append(r);
+            cut = nl + 1;
+            continue;
+        }
+
+        if (pos == 0) {
+            Record r;
+            if (cut > 0 && parseRecord(buf.left(cut), 0, &r)) out.append(r);
+            break;
+        }
+
+        const qint64 chunk = qMin(kChunk, pos);
+        pos -= chunk;
+        if (!f.seek(pos)) break;
+        buf.prepend(f.read(chunk));
+        cut += chunk;
+    }
+
+    std::reverse(out.begin(), out.end());
+    return out;
+}
+
+QVector<Journal::Record> Journal::readRecordsWithOffsets(const QString& path)
+{
+    QVector<Record> out;
+
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return out;
+
+    while (!f.atEnd()) {
+        const qint64 offset = f.pos();
+        Record r;
+        if (parseRecord(f.readLine(), offset, &r)) out.append(r);
+    }
+    return out;
+}
@@ -0,0 +1,43 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+// Append-only журнал операций рядом со снапшотом хранилища.
+// Одна запись = одна строка компактного JSON; на checkpoint журнал
+// сворачивается в свежий снапшот и очищается.
+class Journal
+{
+public:
+    struct Record
+    {
+        qint64 offset = 0;   // начало строки записи в файле
+        QJsonObject object;
+    };
+
+    explicit Journal(const QString& path = QString());
+
+    QString path() const { return m_path; }
+    void setPath(const QString& path) { m_path = path; }
+
+    bool append(const QJsonObject& record);
+    bool append(const QVector<QJsonObject>& records); // одной записью на диск
+    bool clear();
+    // заменить журнал целиком (сжатие); атомарно, через QSaveFile
+    bool rewrite(const QVector<QJsonObject>& records);
+
+    // чтение хвоста журнала; оборванная последняя строка (сбой при записи) пропускается
+    static QVector<QJsonObject> readRecords(const QString& path);
+    // до max последних записей, целиком лежащих до смещения end, в порядке файла.
+    // Файл читается с конца блоками, поэтому цена зависит от max, а не от длины журнала
+    static QVector<Record> readRecordsBefore(const QString& path, qint64 end, int max);
+    // все записи со смещениями (поиск по журналу, когда смещение неизвестно)
+    static QVector<Record> readRecordsWithOffsets(const QString& path);
+
+private:
+    QString m_path;
+};
+
+#endif // JOURNAL_H
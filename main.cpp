@@ -1,8 +1,13 @@
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
 #include <QQmlContext>
+#include <QtQml/qqml.h>
 
 #include "datamanager.h"
+#include "servicelistmodel.h"
+#include "requestlistmodel.h"
+#include "messagelistmodel.h"
+#include "reviewlistmodel.h"
 
 int main(int argc, char *argv[])
 {
@@ -10,9 +15,18 @@ int main(int argc, char *argv[])
     QQmlApplicationEngine engine;
 
     engine.rootContext()->setContextProperty("dataManager", &DataManager::instance());
+    qmlRegisterType<ServiceListModel>("ServiceHub", 1, 0, "ServiceListModel");
+    qmlRegisterType<RequestListModel>("ServiceHub", 1, 0, "RequestListModel");
+    qmlRegisterType<MessageListModel>("ServiceHub", 1, 0, "MessageListModel");
+    qmlRegisterType<ReviewListModel>("ServiceHub", 1, 0, "ReviewListModel");
+    QObject::connect(&app, &QCoreApplication::aboutToQuit,
+                     &DataManager::instance(), &DataManager::shutdown);
 
     const QUrl url(QStringLiteral("qrc:/ALDA_FINAL/main.qml"));
     engine.load(url);
     if (engine.rootObjects().isEmpty()) return -1;
+
+    // окно уже показано, данные догружаются в фоне
+    DataManager::instance().startLoading();
     return app.exec();
 }
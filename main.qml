@@ -2,6 +2,7 @@ import QtQuick 2.15
 import QtQuick.Controls 2.15
 import QtQuick.Layouts 1.15
 import QtQuick.Window 2.15
+import ServiceHub 1.0
 
 ApplicationWindow {
     id: mainWindow
@@ -38,361 +39,8 @@ ApplicationWindow {
         currentPageIndex = index
     }
 
-    // ======= Local "storage" for services (UI-model) =======
-    ListModel {
-        id: serviceModel
-        ListElement {
-            sid: "00000000-0000-0000-0000-000000000001"
-            providerId: "00000000-0000-0000-0000-0000000000AA"
-            title: "Web Design"
-            description: "Landing page + responsive."
-            category: "Design"
-            price: 50000
-            active: true
-            rating: 4.8
-            mediaCsv: "cover.png;portfolio1.png"
-            createdAtIso: "2026-01-01T12:00:00"
-        }
-        ListElement {
-            sid: "00000000-0000-0000-0000-000000000002"
-            providerId: "00000000-0000-0000-0000-0000000000BB"
-            title: "App Development"
-            description: "Mobile app MVP."
-            category: "Development"
-            price: 100000
-            active: true
-            rating: 4.9
-            mediaCsv: "app.png"
-            createdAtIso: "2026-01-02T12:00:00"
-        }
-    }
-
-    QtObject {
-        id: catalog
-
-        property var _categories: ([])
-        property var _searchHistory: ([])
-
-        // ===== helpers =====
-        function _trim(s) { return (s === undefined || s === null) ? "" : String(s).trim() }
-        function _lower(s) { return _trim(s).toLowerCase() }
-
-        function _indexOfId(id) {
-            var sid = _trim(id)
-            if (sid.length === 0) return -1
-            for (var i = 0; i < serviceModel.count; ++i) {
-                var s = serviceModel.get(i)
-                if (_trim(s.sid) === sid) return i
-            }
-            return -1
-        }
-
-        function _ensureCategory(category) {
-            var c = _trim(category)
-            if (c.length === 0) return
-            if (_categories.indexOf(c) === -1) _categories.push(c)
-        }
-
-        function rebuildCategoriesFromServices() {
-            _categories = []
-            for (var i = 0; i < serviceModel.count; ++i)
-                _ensureCategory(serviceModel.get(i).category)
-        }
-
-        function _cloneService(s) {
-            return {
-                sid: _trim(s.sid),
-                providerId: _trim(s.providerId),
-                title: _trim(s.title),
-                description: _trim(s.description),
-                category: _trim(s.category),
-                price: normalizePrice(s.price),
-                active: !!s.active,
-                rating: clampRating(s.rating),
-                mediaCsv: _trim(s.mediaCsv),
-                createdAtIso: _trim(s.createdAtIso)
-            }
-        }
-
-        function _serviceToJsonObj(s) {
-            return {
-                id: _trim(s.sid),
-                providerId: _trim(s.providerId),
-                title: _trim(s.title),
-                description: _trim(s.description),
-                category: _trim(s.category),
-                price: normalizePrice(s.price),
-                active: !!s.active,
-                rating: clampRating(s.rating),
-                createdAt: _trim(s.createdAtIso),
-                media: mediaListFromCsv(_trim(s.mediaCsv))
-            }
-        }
-
-        function _serviceFromJsonObj(obj) {
-            function safeStr(x) { return (x === undefined || x === null) ? "" : String(x) }
-            function safeBool(x) { return !!x }
-            function safeNum(x) {
-                var n = Number(x)
-                if (isNaN(n)) n = 0
-                return n
-            }
-
-            var mediaArr = (obj.media && obj.media.length) ? obj.media : []
-            var csv = mediaCsvFromList(mediaArr.map(function(it){ return safeStr(it) }))
-
-            return {
-                sid: safeStr(obj.id),
-                providerId: safeStr(obj.providerId),
-                title: safeStr(obj.title),
-                description: safeStr(obj.description),
-                category: safeStr(obj.category),
-                price: normalizePrice(safeNum(obj.price)),
-                active: safeBool(obj.active),
-                rating: clampRating(safeNum(obj.rating)),
-                mediaCsv: csv,
-                createdAtIso: safeStr(obj.createdAt)
-            }
-        }
-
-        function _allServicesArray() {
-            var arr = []
-            for (var i = 0; i < serviceModel.count; ++i)
-                arr.push(_cloneService(serviceModel.get(i)))
-            return arr
-        }
-
-        // ===== API =====
-        function addService(serviceObj) {
-            var s = _cloneService(serviceObj)
-            if (_trim(s.sid).length === 0) return false
-
-            var idx = _indexOfId(s.sid)
-            if (idx >= 0) {
-                serviceModel.setProperty(idx, "providerId", s.providerId)
-                serviceModel.setProperty(idx, "title", s.title)
-                serviceModel.setProperty(idx, "description", s.description)
-                serviceModel.setProperty(idx, "category", s.category)
-                serviceModel.setProperty(idx, "price", s.price)
-                serviceModel.setProperty(idx, "active", s.active)
-                serviceModel.setProperty(idx, "rating", s.rating)
-                serviceModel.setProperty(idx, "mediaCsv", s.mediaCsv)
-                serviceModel.setProperty(idx, "createdAtIso", s.createdAtIso)
-            } else {
-                serviceModel.append(s)
-            }
-
-            _ensureCategory(s.category)
-            return true
-        }
-
-        function removeService(serviceId) {
-            var idx = _indexOfId(serviceId)
-            if (idx < 0) return false
-            serviceModel.remove(idx)
-            catalog.rebuildCategoriesFromServices()
-            return true
-        }
-
-        function updateService(serviceObj) {
-            var s = _cloneService(serviceObj)
-            var idx = _indexOfId(s.sid)
-            if (idx < 0) return false
-
-            serviceModel.setProperty(idx, "providerId", s.providerId)
-            serviceModel.setProperty(idx, "title", s.title)
-            serviceModel.setProperty(idx, "description", s.description)
-            serviceModel.setProperty(idx, "category", s.category)
-            serviceModel.setProperty(idx, "price", s.price)
-            serviceModel.setProperty(idx, "active", s.active)
-            serviceModel.setProperty(idx, "rating", s.rating)
-            serviceModel.setProperty(idx, "mediaCsv", s.mediaCsv)
-            serviceModel.setProperty(idx, "createdAtIso", s.createdAtIso)
-
-            _ensureCategory(s.category)
-            return true
-        }
-
-        function searchByName(name) {
-            var q = _trim(name)
-            if (q.length === 0) return []
-            var out = []
-            for (var i = 0; i < serviceModel.count; ++i) {
-                var s = serviceModel.get(i)
-                if (_lower(s.title).indexOf(q.toLowerCase()) !== -1)
-                    out.push(_cloneService(s))
-            }
-            return out
-        }
-
-        function searchByDescription(text) {
-            var q = _trim(text)
-            if (q.length === 0) return []
-            var out = []
-            for (var i = 0; i < serviceModel.count; ++i) {
-                var s = serviceModel.get(i)
-                if (_lower(s.description).indexOf(q.toLowerCase()) !== -1)
-                    out.push(_cloneService(s))
-            }
-            return out
-        }
-
-        function filterByCategory(category) {
-            var c = _trim(category)
-            if (c.length === 0) return []
-            var out = []
-            for (var i = 0; i < serviceModel.count; ++i) {
-                var s = serviceModel.get(i)
-                if (_trim(s.category) === c)
-                    out.push(_cloneService(s))
-            }
-            return out
-        }
-
-        function filterByPrice(minPrice, maxPrice) {
-            var minP = Number(minPrice)
-            var maxP = Number(maxPrice)
-            if (isNaN(minP)) minP = 0
-            if (isNaN(maxP)) maxP = 0
-            if (minP > maxP) return []
-
-            var out = []
-            for (var i = 0; i < serviceModel.count; ++i) {
-                var s = serviceModel.get(i)
-                var p = Number(s.price)
-                if (isNaN(p)) p = 0
-                if (p >= minP && p <= maxP) out.push(_cloneService(s))
-            }
-            return out
-        }
-
-        function filterByRating(minRating) {
-            var r0 = Number(minRating)
-            if (isNaN(r0)) r0 = 0
-            var out = []
-            for (var i = 0; i < serviceModel.count; ++i) {
-                var s = serviceModel.get(i)
-                var r = Number(s.rating)
-                if (isNaN(r)) r = 0
-                if (r >= r0) out.push(_cloneService(s))
-            }
-            return out
-        }
-
-        function getActiveServices() {
-            var out = []
-            for (var i = 0; i < serviceModel.count; ++i) {
-                var s = serviceModel.get(i)
-                if (!!s.active) out.push(_cloneService(s))
-            }
-            return out
-        }
-
-        function getPopularServices(count) {
-            var n = Number(count)
-            if (isNaN(n) || n < 0) n = 0
-
-            var sorted = _allServicesArray()
-            for (var i = 0; i < sorted.length - 1; ++i) {
-                for (var j = i + 1; j < sorted.length; ++j) {
-                    if (Number(sorted[i].rating) < Number(sorted[j].rating)) {
-                        var tmp = sorted[i]; sorted[i] = sorted[j]; sorted[j] = tmp
-                    }
-                }
-            }
-            if (sorted.length > n) sorted = sorted.slice(0, n)
-            return sorted
-        }
-
-        function getNewServices(count) {
-            var n = Number(count)
-            if (isNaN(n) || n < 0) n = 0
-
-            var sorted = _allServicesArray()
-            function dt(iso) {
-                var d = Date.parse(_trim(iso))
-                return isNaN(d) ? 0 : d
-            }
-
-            for (var i = 0; i < sorted.length - 1; ++i) {
-                for (var j = i + 1; j < sorted.length; ++j) {
-                    if (dt(sorted[i].createdAtIso) < dt(sorted[j].createdAtIso)) {
-                        var tmp = sorted[i]; sorted[i] = sorted[j]; sorted[j] = tmp
-                    }
-                }
-            }
-            if (sorted.length > n) sorted = sorted.slice(0, n)
-            return sorted
-        }
-
-        function getAllServices() { return _allServicesArray() }
-        function getCategories() { return _categories.slice(0) }
-        function getSearchHistory() { return _searchHistory.slice(0) }
-
-        function addSearchHistory(query) {
-            var q = _trim(query)
-            if (q.length === 0) return
-            var out = [q]
-            for (var i = 0; i < _searchHistory.length; ++i) {
-                if (_searchHistory[i] !== q) out.push(_searchHistory[i])
-                if (out.length >= 50) break
-            }
-            _searchHistory = out
-        }
-
-        function getInfo() {
-            return "Каталог: " + serviceModel.count + " услуг в " + _categories.length + " категориях"
-        }
-
-        function getFullInfo() {
-            return "=== КАТАЛОГ ===\n"
-                 + "Услуг: " + serviceModel.count + "\n"
-                 + "Категорий: " + _categories.length + "\n"
-                 + "История поиска: " + _searchHistory.length
-        }
-
-        function toJson() {
-            var servicesArray = []
-            for (var i = 0; i < serviceModel.count; ++i) {
-                servicesArray.push(_serviceToJsonObj(serviceModel.get(i)))
-            }
-            return {
-                services: servicesArray,
-                categories: _categories.slice(0),
-                searchHistory: _searchHistory.slice(0)
-            }
-        }
-
-        function fromJson(obj) {
-            if (!obj) return false
-
-            _categories = []
-            if (obj.categories && obj.categories.length) {
-                for (var i = 0; i < obj.categories.length; ++i) {
-                    var c = _trim(obj.categories[i])
-                    if (c.length) _categories.push(c)
-                }
-            }
-
-            _searchHistory = []
-            if (obj.searchHistory && obj.searchHistory.length) {
-                for (var j = 0; j < obj.searchHistory.length; ++j) {
-                    var h = _trim(obj.searchHistory[j])
-                    if (h.length) _searchHistory.push(h)
-                }
-            }
-
-            serviceModel.clear()
-            if (obj.services && obj.services.length) {
-                for (var k = 0; k < obj.services.length; ++k) {
-                    var s = _serviceFromJsonObj(obj.services[k])
-                    serviceModel.append(s)
-                    _ensureCategory(s.category)
-                }
-            }
-            return true
-        }
-    }
+    // ======= Services: C++ Catalog через ServiceListModel (единственный источник) =======
+    ServiceListModel { id: serviceModel }
 
     // ======= Helpers matching C++ Service behavior =======
     function clampRating(r) {
@@ -472,10 +120,11 @@ ApplicationWindow {
         }
 
         var mediaArr = (obj.media && obj.media.length) ? obj.media : []
-        var csv = mediaCsvFromList(mediaArr.map(function(it){ return safeStr(it) }))
+        var sid = safeStr(obj.id).trim()
+        if (sid === "") sid = dataManager.newServiceId()
 
-        serviceModel.append({
-            sid: safeStr(obj.id),
+        var ok = dataManager.addService({
+            id: sid,
             providerId: safeStr(obj.providerId),
             title: safeStr(obj.title),
             description: safeStr(obj.description),
@@ -483,11 +132,15 @@ ApplicationWindow {
             price: normalizePrice(safeNum(obj.price)),
             active: safeBool(obj.active),
             rating: clampRating(safeNum(obj.rating)),
-            mediaCsv: csv,
-            createdAtIso: safeStr(obj.createdAt)
+            createdAt: safeStr(obj.createdAt),
+            media: mediaArr.map(function(it){ return safeStr(it) })
         })
+        if (!ok) {
+            serviceLog("Import failed (catalog not loaded yet?)")
+            return
+        }
 
-        servicePage.currentServiceIndex = serviceModel.count - 1
+        servicePage.currentServiceIndex = serviceModel.indexOf(sid)
         servicePage.loadServiceToEditor(servicePage.currentServiceIndex)
         serviceLog("Imported service from JSON.")
     }
@@ -599,6 +252,26 @@ ApplicationWindow {
                     }
                 }
 
+                // данные грузятся в фоне: окно уже работает, страницы заполняются по *Changed
+                ColumnLayout {
+                    Layout.fillWidth: true
+                    visible: !dataManager.ready
+                    spacing: 4
+
+                    Text {
+                        text: "Loading data… " + Math.round(dataManager.loadingProgress * 100) + "%"
+                        color: "#9aa7b5"
+                        font.pixelSize: 12
+                    }
+
+                    ProgressBar {
+                        Layout.fillWidth: true
+                        from: 0
+                        to: 1
+                        value: dataManager.loadingProgress
+                    }
+                }
+
                 Rectangle { Layout.fillWidth: true; height: 2; color: "#2196F3" }
 
                 ScrollView {
@@ -740,6 +413,27 @@ ApplicationWindow {
                     function setInfo(msg) { uiInfo = msg; uiError = "" }
                     function setError(msg) { uiError = msg; uiInfo = "" }
 
+                    // хеш пароля считается в фоне, ответ приходит сигналом
+                    Connections {
+                        target: dataManager
+                        function onLoginFinished(ok) {
+                            if (ok) {
+                                userPage.setInfo("Logged in successfully")
+                                gotoPage(0)
+                            } else {
+                                userPage.setError("Login failed: wrong credentials")
+                            }
+                        }
+                        function onRegisterFinished(ok) {
+                            if (ok) { userPage.setInfo("Account created and logged in"); gotoPage(2) }
+                            else userPage.setError("Registration failed (email exists or invalid data)")
+                        }
+                        function onPasswordChangeFinished(ok) {
+                            if (ok) userPage.setInfo("Password changed")
+                            else userPage.setError("Password change failed")
+                        }
+                    }
+
                     ScrollView {
                         id: userSv
                         anchors.fill: parent
@@ -807,16 +501,11 @@ ApplicationWindow {
                                                 text: "Login"
                                                 Layout.fillWidth: true
                                                 Layout.preferredHeight: 42
+                                                enabled: !dataManager.authBusy
                                                 onClicked: {
                                                     userPage.setInfo("")
                                                     userPage.setError("")
-                                                    var ok = dataManager.login(loginEmail.text, loginPass.text)
-                                                    if (ok) {
-                                                        userPage.setInfo("Logged in successfully")
-                                                        gotoPage(0)
-                                                    } else {
-                                                        userPage.setError("Login failed: wrong credentials")
-                                                    }
+                                                    dataManager.loginAsync(loginEmail.text, loginPass.text)
                                                 }
                                             }
                                         }
@@ -859,12 +548,11 @@ ApplicationWindow {
                                                     horizontalAlignment: Text.AlignHCenter
                                                     verticalAlignment: Text.AlignVCenter
                                                 }
+                                                enabled: !dataManager.authBusy
                                                 onClicked: {
                                                     userPage.setInfo("")
                                                     userPage.setError("")
-                                                    var ok = dataManager.registerUser(regEmail.text, regPhone.text, regRole.currentIndex, regPass.text)
-                                                    if (ok) { userPage.setInfo("Account created and logged in"); gotoPage(2) }
-                                                    else userPage.setError("Registration failed (email exists or invalid data)")
+                                                    dataManager.registerUserAsync(regEmail.text, regPhone.text, regRole.currentIndex, regPass.text)
                                                 }
                                             }
                                         }
@@ -972,12 +660,11 @@ ApplicationWindow {
                                         text: "Update password"
                                         Layout.fillWidth: true
                                         Layout.preferredHeight: 42
+                                        enabled: !dataManager.authBusy
                                         onClicked: {
                                             userPage.setInfo("")
                                             userPage.setError("")
-                                            var ok = dataManager.changePassword(oldPass.text, newPass.text)
-                                            if (ok) userPage.setInfo("Password changed")
-                                            else userPage.setError("Password change failed")
+                                            dataManager.changePasswordAsync(oldPass.text, newPass.text)
                                         }
                                     }
 
@@ -1236,21 +923,21 @@ ApplicationWindow {
                                 Layout.preferredWidth: 200
                                 Layout.preferredHeight: 42
                                 onClicked: {
-                                    var id = servicePage.newUuidLike()
-                                    serviceModel.append({
+                                    var id = dataManager.newServiceId()
+                                    var ok = dataManager.addService(serviceToJsonObject({
                                         sid: id,
                                         providerId: providerIdField.text.trim(),
                                         title: titleField.text,
                                         description: descriptionArea.text,
                                         category: categoryField.text,
-                                        price: normalizePrice(priceField.text),
+                                        price: priceField.text,
                                         active: activeSwitch.checked,
-                                        rating: clampRating(ratingField.text),
+                                        rating: ratingField.text,
                                         mediaCsv: mediaCsvField.text.trim(),
                                         createdAtIso: (createdAtField.text.trim() !== "") ? createdAtField.text.trim() : new Date().toISOString()
-                                    })
-                                    catalog.rebuildCategoriesFromServices()
-                                    serviceList.currentIndex = serviceModel.count - 1
+                                    }))
+                                    if (!ok) { serviceLog("Create failed (catalog not loaded yet?)"); return }
+                                    serviceList.currentIndex = serviceModel.indexOf(id)
                                     serviceLog("Created new service (from editor).")
                                 }
                             }
@@ -1278,7 +965,7 @@ ApplicationWindow {
                                         Layout.fillWidth: true
                                         spacing: 8
                                         Text { text: "Services"; color: "#61dafb"; font.bold: true; font.pixelSize: 14; Layout.fillWidth: true }
-                                        Text { text: "(" + serviceModel.count + ")"; color: "#888"; font.pixelSize: 12 }
+                                        Text { text: "(" + dataManager.serviceCount + ")"; color: "#888"; font.pixelSize: 12 }
                                     }
 
                                     ListView {
@@ -1354,16 +1041,19 @@ ApplicationWindow {
                                             onClicked: {
                                                 var idx = serviceList.currentIndex
                                                 if (idx < 0) return
-                                                serviceModel.remove(idx)
-                                                catalog.rebuildCategoriesFromServices()
+                                                if (!dataManager.deleteService(serviceModel.idAt(idx))) {
+                                                    serviceLog("Delete failed.")
+                                                    return
+                                                }
                                                 if (serviceModel.count > 0) {
                                                     serviceList.currentIndex = Math.min(idx, serviceModel.count - 1)
+                                                    servicePage.loadServiceToEditor(serviceList.currentIndex)
                                                 } else {
                                                     serviceList.currentIndex = -1
                                                     servicePage.currentServiceIndex = -1
                                                     clearEditor()
                                                 }
-                                                serviceLog("Deleted service (UI).")
+                                                serviceLog("Deleted service.")
                                             }
                                         }
 
@@ -1376,19 +1066,25 @@ ApplicationWindow {
                                                 var idx = serviceList.currentIndex
                                                 if (idx < 0) return
 
-                                                serviceModel.setProperty(idx, "sid", sidField.text.trim())
-                                                serviceModel.setProperty(idx, "providerId", providerIdField.text.trim())
-                                                serviceModel.setProperty(idx, "title", titleField.text)
-                                                serviceModel.setProperty(idx, "description", descriptionArea.text)
-                                                serviceModel.setProperty(idx, "category", categoryField.text)
-                                                serviceModel.setProperty(idx, "price", normalizePrice(priceField.text))
-                                                serviceModel.setProperty(idx, "active", activeSwitch.checked)
-                                                serviceModel.setProperty(idx, "rating", clampRating(ratingField.text))
-                                                serviceModel.setProperty(idx, "mediaCsv", mediaCsvField.text.trim())
-                                                serviceModel.setProperty(idx, "createdAtIso", createdAtField.text.trim())
-                                                catalog.rebuildCategoriesFromServices()
-                                                servicePage.loadServiceToEditor(idx)
-                                                serviceLog("Saved changes (UI).")
+                                                var sid = sidField.text.trim()
+                                                var ok = dataManager.updateService(serviceToJsonObject({
+                                                    sid: sid,
+                                                    providerId: providerIdField.text.trim(),
+                                                    title: titleField.text,
+                                                    description: descriptionArea.text,
+                                                    category: categoryField.text,
+                                                    price: priceField.text,
+                                                    active: activeSwitch.checked,
+                                                    rating: ratingField.text,
+                                                    mediaCsv: mediaCsvField.text.trim(),
+                                                    createdAtIso: createdAtField.text.trim()
+                                                }))
+                                                if (!ok) { serviceLog("Save failed (unknown id?)"); return }
+
+                                                // при смене даты строка могла переехать
+                                                serviceList.currentIndex = serviceModel.indexOf(sid)
+                                                servicePage.loadServiceToEditor(serviceList.currentIndex)
+                                                serviceLog("Saved changes.")
                                             }
                                         }
                                     }
@@ -1609,8 +1305,12 @@ ApplicationWindow {
                         }
                     }
 
-                    function newUuidLike() {
-                        return "demo-" + Date.now() + "-" + Math.floor(Math.random()*100000)
+                    // каталог догружается в фоне: выбираем первую строку, когда она появится
+                    Connections {
+                        target: serviceModel
+                        function onCountChanged() {
+                            if (serviceList.currentIndex < 0 && serviceModel.count > 0) serviceList.currentIndex = 0
+                        }
                     }
                 }
 
@@ -1620,10 +1320,11 @@ ApplicationWindow {
                 Item {
                     id: catalogPage
 
-                    ListModel { id: catalogModel }     // services shown now
+                    ServiceListModel { id: catalogModel }  // services shown now (query задаётся режимом)
                     ListModel { id: historyModel }     // search history shown at left
 
-                    property string statusText: ""
+                    property string statusLabel: ""
+                    property string statusText: statusLabel + " (" + catalogModel.count + ")"
                     property var favServiceIds: []
 
                     function t(x) { return (x === undefined || x === null) ? "" : String(x).trim() }
@@ -1646,37 +1347,33 @@ ApplicationWindow {
                     // -------- existing catalog helpers --------
                     function rebuildHistoryModel() {
                         historyModel.clear()
-                        var hist = catalog.getSearchHistory()
+                        var hist = dataManager.catalogGetSearchHistory()
                         for (var j = 0; j < hist.length; ++j)
                             historyModel.append({ q: hist[j] })
                     }
 
-                    function loadList(list, label) {
-                        catalogModel.clear()
-                        for (var i = 0; i < list.length; ++i)
-                            catalogModel.append(list[i])
-                        statusText = label + " (" + list.length + ")"
+                    // фильтры, сортировка и top-K выполняются в C++ (Catalog::query)
+                    function showQuery(spec, label) {
+                        catalogModel.query = spec
+                        statusLabel = label
                         rebuildHistoryModel()
                     }
 
-                    function reloadAll()    { loadList(catalog.getAllServices(), "All services") }
-                    function reloadActive() { loadList(catalog.getActiveServices(), "Active") }
-                    function reloadPopular(){ loadList(catalog.getPopularServices(10), "Popular top 10") }
-                    function reloadNew()    { loadList(catalog.getNewServices(10), "New top 10") }
+                    function reloadAll()    { showQuery({}, "All services") }
+                    function reloadActive() { showQuery({ activeOnly: true }, "Active") }
+                    function reloadPopular(){ showQuery({ sort: "rating", limit: 10 }, "Popular top 10") }
+                    function reloadNew()    { showQuery({ sort: "newest", limit: 10 }, "New top 10") }
 
                     function runSearch(q) {
                         var qq = t(q)
-                        catalog.addSearchHistory(qq)
-                        loadList(catalog.searchByName(qq), "Search: " + qq)
+                        dataManager.catalogAddSearchHistory(qq)
+                        // пустой запрос, как и раньше, ничего не находит
+                        showQuery(qq.length ? { text: qq } : { limit: 0 }, "Search: " + qq)
                     }
 
                     // -------- sync --------
-                    onVisibleChanged: if (visible) { reloadAll(); refreshFavCache() }
-
-                    Connections {
-                        target: serviceModel
-                        function onCountChanged() { if (catalogPage.visible) catalogPage.reloadAll() }
-                    }
+                    // catalogModel живой: изменения каталога приходят в него сами
+                    onVisibleChanged: if (visible) refreshFavCache()
 
                     Connections {
                         target: dataManager
@@ -1707,7 +1404,7 @@ ApplicationWindow {
                             }
 
                             Text {
-                                text: serviceModel.count
+                                text: dataManager.serviceCount
                                 color: "white"
                                 font.pixelSize: 12
                                 elide: Text.ElideRight
@@ -2029,29 +1726,19 @@ ApplicationWindow {
                         reqStatusCombo.currentIndex = st
 
                         reqCommentField.text = ""
-                        reqCommentsView.text = request.commentsText || ""
+                        // в строке заявки только число комментариев и последний; вся история — в чате
+                        reqCommentsView.text = request.commentCount > 0
+                                ? request.commentCount + " comment(s), last (" + request.lastCommentAt + "):\n" + request.lastComment
+                                : ""
                     }
 
-                    ListModel { id: requestListModel }
-
-                    function reloadRequests() {
-                        requestListModel.clear()
-                        var list = dataManager.getAllRequests()
-                        for (var i = 0; i < list.length; ++i) {
-                            var r = list[i]
-                            var comms = r.comments || []
-                            var commText = ""
-                            if (Array.isArray(comms)) {
-                                for(var j=0; j<comms.length; j++) commText += "• " + comms[j] + "\n"
-                            }
-                            requestListModel.append({
-                                id: r.id, serviceId: r.serviceId, clientId: r.clientId, providerId: r.providerId,
-                                status: r.status, description: r.description, createdAt: r.createdAt, completedAt: r.completedAt,
-                                commentsText: commText
-                            })
-                        }
+                    // C++ модель: точечные обновления строк вместо полной перестройки списка
+                    RequestListModel { id: requestListModel }
+
+                    function reloadRequests() { requestListModel.reload() } // -> onModelReset
 
-                        // Пытаемся сохранить выбор или выбрать первый элемент
+                    // Пытаемся сохранить выбор или выбрать первый элемент
+                    function selectCurrentOrFirst() {
                         if (requestListModel.count > 0) {
                             if (currentRequestIndex < 0 || currentRequestIndex >= requestListModel.count)
                                 currentRequestIndex = 0
@@ -2063,10 +1750,17 @@ ApplicationWindow {
                     }
 
                     Connections {
-                        target: dataManager
-                        function onRequestsChanged() { requestPage.reloadRequests() }
-                        function onLoggedInChanged() { requestPage.reloadRequests() }
-                        Component.onCompleted: requestPage.reloadRequests()
+                        target: requestListModel
+                        function onModelReset() { requestPage.selectCurrentOrFirst() }
+                        function onDataChanged(topLeft, bottomRight) {
+                            var cur = requestListView.currentIndex
+                            if (cur >= topLeft.row && cur <= bottomRight.row)
+                                requestPage.loadRequestToEditor(cur)
+                        }
+                        function onCountChanged() {
+                            if (requestListModel.count === 0) requestPage.clearEditor()
+                        }
+                        Component.onCompleted: requestPage.selectCurrentOrFirst()
                     }
 
                     ColumnLayout {
@@ -2235,7 +1929,7 @@ ApplicationWindow {
                                             }
                                         }
 
-                                        FieldLabel { text: "Comments History" }
+                                        FieldLabel { text: "Last Comment" }
                                         TextArea {
                                             id: reqCommentsView; Layout.fillWidth: true; Layout.preferredHeight: 100; readOnly: true; color: "#ccc"; wrapMode: TextArea.Wrap
                                             background: Rectangle { color: "#1a1a1a"; radius: 6; border.color: "#444"; border.width: 1 }
@@ -2270,29 +1964,11 @@ ApplicationWindow {
                         reloadMessages()
                     }
 
-                    // Обновление сообщений
+                    // Сообщения приходят из MessageListModel сами (сигнал commentAdded)
                     function reloadMessages() {
-                        if (currentRequestId === "" || !messagePage.visible) return
-
-                        // Берем все заявки и ищем ту, что открыта
-                        var reqs = dataManager.getAllRequests()
-                        messageModel.clear()
-
-                        for (var i = 0; i < reqs.length; ++i) {
-                            if (reqs[i].id === currentRequestId) {
-                                var comments = reqs[i].comments || []
-                                for (var j = 0; j < comments.length; ++j) {
-                                    // В текущей реализации C++ все комментарии — это сообщения
-                                    messageModel.append({
-                                        content: comments[j],
-                                        isMe: true, // Для простоты считаем все своими, либо добавь логику проверки автора
-                                        time: ""
-                                    })
-                                }
-                                break
-                            }
-                        }
+                        messageModel.reload()
                         msgListView.positionViewAtEnd()
+                        dataManager.markConversationRead(currentRequestId)
                     }
 
                     // ТА САМАЯ ФУНКЦИЯ ОТПРАВКИ
@@ -2300,25 +1976,19 @@ ApplicationWindow {
                         var txt = chatInput.text.trim()
                         if (txt === "" || currentRequestId === "") return
 
-                        // ВАЖНО: Вызываем addRequestComment (этот метод 100% есть в твоем DataManager.cpp)
-                        var ok = dataManager.addRequestComment(currentRequestId, txt)
+                        // беседа заявки: id беседы = id заявки
+                        var ok = dataManager.sendMessage(currentRequestId, txt)
 
                         if (ok) {
                             console.log("Message sent successfully")
-                            chatInput.text = "" // Очищаем поле
-                            reloadMessages()    // Мгновенно обновляем список
+                            chatInput.text = "" // Очищаем поле; новая строка уже в messageModel
                         } else {
                             console.log("Error sending message")
                         }
                     }
 
-                    ListModel { id: messageModel }
-
-                    // Автообновление (чтобы видеть новые сообщения)
-                    Timer {
-                        interval: 2000; running: messagePage.visible && currentRequestId !== ""; repeat: true
-                        onTriggered: messagePage.reloadMessages()
-                    }
+                    // открытие чата грузит одну страницу; старые — loadOlder() у верхнего края
+                    MessageListModel { id: messageModel; conversationId: messagePage.currentRequestId }
 
                     ColumnLayout {
                         anchors.fill: parent; spacing: 0
@@ -2352,6 +2022,24 @@ ApplicationWindow {
                             model: messageModel; spacing: 10
                             leftMargin: 15; rightMargin: 15; topMargin: 15; bottomMargin: 15
 
+                            // у верхнего края подгружаем более старые сообщения
+                            onAtYBeginningChanged: if (atYBeginning && messageModel.hasOlder) messageModel.loadOlder()
+
+                            Connections {
+                                target: messageModel
+                                function onModelReset() { msgListView.positionViewAtEnd() }
+                                function onRowsInserted(parent, first, last) {
+                                    // старая страница встала сверху — остаёмся на том же сообщении
+                                    if (first === 0 && messageModel.count > last + 1)
+                                        msgListView.positionViewAtIndex(last + 1, ListView.Beginning)
+                                    else {
+                                        msgListView.positionViewAtEnd()
+                                        // чат открыт — новое сообщение сразу прочитано
+                                        if (messagePage.visible) dataManager.markConversationRead(messagePage.currentRequestId)
+                                    }
+                                }
+                            }
+
                             delegate: ColumnLayout {
                                 width: msgListView.width - 30
                                 Layout.alignment: isMe ? Qt.AlignRight : Qt.AlignLeft
@@ -2413,88 +2101,20 @@ ApplicationWindow {
                     function setInfo(msg) { uiInfo = msg; uiError = "" }
                     function setError(msg) { uiError = msg; uiInfo = "" }
 
-                    // Локальное хранилище отзывов (в памяти QML)
-                    QtObject {
-                        id: reviewStore
-                        property var _byService: ({}) // { serviceId: [ {authorId, rating, comment, createdAt}, ... ] }
-
-                        function _ensure(serviceId) {
-                            var sid = (serviceId || "").trim()
-                            if (sid === "") return []
-                            if (!_byService[sid])
-                                _byService[sid] = []
-                            return _byService[sid]
-                        }
-
-                        function list(serviceId) {
-                            var arr = _ensure(serviceId)
-                            // копия массива, чтобы случайно не мутировать
-                            return arr.slice(0)
-                        }
-
-                        function add(serviceId, authorId, rating, comment) {
-                            var sid = (serviceId || "").trim()
-                            if (sid === "") return false
-
-                            var c = (comment || "").trim()
-                            if (c.length === 0) return false
-
-                            var r = Number(rating)
-                            if (isNaN(r)) r = 0
-                            if (r < 1) r = 1
-                            if (r > 5) r = 5
-
-                            var a = (authorId || "").trim()
-                            if (a === "") a = "anonymous"
-
-                            var arr = _ensure(sid)
-                            arr.unshift({
-                                authorId: a,
-                                rating: r,
-                                comment: c,
-                                createdAt: new Date().toISOString()
-                            })
-
-                            // опционально ограничим историю
-                            if (arr.length > 200) arr.pop()
-                            return true
-                        }
-
-                        function seedIfEmpty(serviceId) {
-                            var arr = _ensure(serviceId)
-                            if (arr.length > 0) return
-                            arr.push({ authorId: "demo-user", rating: 5, comment: "Отличный сервис!", createdAt: "2026-01-10T10:00:00Z" })
-                            arr.push({ authorId: "demo-user2", rating: 4, comment: "Хорошо, но можно быстрее.", createdAt: "2026-01-11T10:00:00Z" })
-                        }
+                    // отзывы выбранной услуги из C++ (reviews.json), страницами
+                    ReviewListModel {
+                        id: reviewModel
+                        serviceId: reviewPage.currentServiceId
                     }
 
-                    ListModel { id: reviewModel }
-
                     function loadReviews(serviceId) {
                         uiInfo = ""; uiError = ""
                         currentServiceId = (serviceId || "").trim()
-
-                        reviewModel.clear()
-                        if (currentServiceId === "") return
-
-                        reviewStore.seedIfEmpty(currentServiceId)
-
-                        var list = reviewStore.list(currentServiceId)
-                        for (var i = 0; i < list.length; ++i) {
-                            var r = list[i]
-                            reviewModel.append({
-                                authorId: r.authorId,
-                                rating: r.rating,
-                                comment: r.comment,
-                                createdAt: r.createdAt
-                            })
-                        }
                     }
 
                     function ensureDefaultService() {
                         if (serviceModel.count <= 0) {
                             currentServiceId = ""
-                            reviewModel.clear()
                             return
                         }
 
@@ -2607,10 +2227,7 @@ ApplicationWindow {
                                     text: "Reload"
                                     Layout.preferredWidth: 120
                                     Layout.preferredHeight: 40
-                                    onClicked: {
-                                        if (currentServiceId !== "")
-                                            loadReviews(currentServiceId)
-                                    }
+                                    onClicked: reviewModel.reload()
                                 }
                             }
                         }
@@ -2638,7 +2255,7 @@ ApplicationWindow {
                                         Layout.fillWidth: true
                                         Text { text: "Recent Reviews"; color: "white"; font.bold: true; font.pixelSize: 16 }
                                         Item { Layout.fillWidth: true }
-                                        Text { text: reviewModel.count + ""; color: "#888"; font.pixelSize: 12 }
+                                        Text { text: reviewModel.total + ""; color: "#888"; font.pixelSize: 12 }
                                     }
 
                                     ListView {
@@ -2825,16 +2442,14 @@ ApplicationWindow {
                                             if (isNaN(rating)) rating = 5
                                             rating = Math.max(1, Math.min(5, Math.round(rating)))
 
-                                            var author = String(dataManager.currentUserId || "anonymous")
-
-                                            var ok = reviewStore.add(sid, author, rating, comment)
+                                            // строка появится в reviewModel по сигналу reviewAdded
+                                            var ok = dataManager.addReview(sid, rating, comment)
                                             if (!ok) {
                                                 reviewPage.setError("Failed to add review.")
                                                 return
                                             }
 
                                             reviewInput.text = ""
-                                            reviewPage.loadReviews(sid)
                                             reviewPage.setInfo("Review submitted.")
                                         }
                                     }
@@ -3144,13 +2759,10 @@ ApplicationWindow {
 
                     ListModel { id: favListModel } // { sid, title, category, price }
 
+                    // O(1) поиск по id в C++ каталоге
                     function findServiceInModel(sid) {
-                        var id = t(sid)
-                        for (var i = 0; i < serviceModel.count; ++i) {
-                            var s = serviceModel.get(i)
-                            if (t(s.sid) === id) return s
-                        }
-                        return null
+                        var s = dataManager.getService(t(sid))
+                        return (s && s.id) ? s : null
                     }
 
                     function reloadFavorites() {
@@ -0,0 +1,135 @@
+#include "messagelistmodel.h"
+#include "datamanager.h"
+
+static const int kPageSize = 50;
+
+MessageListModel::MessageListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    DataManager* dm = &DataManager::instance();
+    connect(dm, &DataManager::commentAdded, this, &MessageListModel::onCommentAdded);
+    // беседа открывается по заявке: до загрузки обоих хранилищ страница пуста
+    connect(dm, &DataManager::conversationsReset, this, &MessageListModel::reload);
+    connect(dm, &DataManager::requestsReset, this, &MessageListModel::reload);
+    connect(dm, &DataManager::requestRemoved, this, &MessageListModel::onRequestRemoved);
+    connect(dm, &DataManager::currentUserChanged, this, &MessageListModel::onCurrentUserChanged);
+}
+
+int MessageListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : count();
+}
+
+QVariant MessageListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size()) return QVariant();
+
+    const Message& m = m_rows[index.row()];
+    switch (role) {
+    case Qt::DisplayRole:
+    case ContentRole:   return m.getContent();
+    case IsMeRole:      return !m.getSenderId().isNull()
+                               && m.getSenderId() == QUuid(DataManager::instance().currentUserId());
+    case TimeRole:      return m.getTimestamp().toString("HH:mm");
+    case MessageIdRole: return m.getId().toString(QUuid::WithoutBraces);
+    case SenderIdRole:  return m.getSenderId().toString(QUuid::WithoutBraces);
+    case TimestampRole: return m.getTimestamp().toString(Qt::ISODate);
+    default:            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> MessageListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[ContentRole] = "content";
+    roles[IsMeRole] = "isMe";
+    roles[TimeRole] = "time";
+    roles[MessageIdRole] = "messageId";
+    roles[SenderIdRole] = "senderId";
+    roles[TimestampRole] = "timestamp";
+    return roles;
+}
+
+void MessageListModel::setConversationId(const QString& id)
+{
+    if (id == m_conversationIdText) return;
+    m_conversationIdText = id;
+    m_conversationId = QUuid(id.trimmed());
+    reload();
+    emit conversationIdChanged();
+}
+
+void MessageListModel::reload()
+{
+    QVector<Message> page;
+    m_nextIndex = 0;
+    if (!m_conversationId.isNull()) {
+        page = DataManager::instance().messagesBefore(m_conversationId, kPageSize);
+        m_nextIndex = DataManager::instance().commentCount(m_conversationId);
+    }
+
+    beginResetModel();
+    m_rows.clear();
+    m_rows.reserve(page.size());
+    for (int i = int(page.size()) - 1; i >= 0; --i)
+        m_rows.append(page[i]);
+    m_hasOlder = (page.size() == kPageSize);
+    endResetModel();
+
+    emit countChanged();
+}
+
+void MessageListModel::loadOlder()
+{
+    if (!m_hasOlder || m_rows.isEmpty()) return;
+
+    const QVector<Message> page = DataManager::instance().messagesBefore(m_conversationId, kPageSize,
+                                                                         m_rows.first().getId());
+    m_hasOlder = (page.size() == kPageSize);
+    if (page.isEmpty()) {
+        emit countChanged();
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), 0, int(page.size()) - 1);
+    QVector<Message> rows;
+    rows.reserve(page.size() + m_rows.size());
+    for (int i = int(page.size()) - 1; i >= 0; --i)
+        rows.append(page[i]);
+    rows += m_rows;
+    m_rows = rows;
+    endInsertRows();
+
+    emit countChanged();
+}
+
+void MessageListModel::onCurrentUserChanged()
+{
+    if (m_rows.isEmpty()) return;
+    emit dataChanged(index(0), index(count() - 1), { IsMeRole });
+}
+
+void MessageListModel::onCommentAdded(const QString& requestId, int index)
+{
+    if (m_conversationId.isNull() || QUuid(requestId) != m_conversationId) return;
+    if (index < m_nextIndex) return; // уже в списке
+
+    const Message* m = (index == m_nextIndex)
+        ? DataManager::instance().recentMessage(m_conversationId, index) : nullptr;
+    if (!m) {
+        reload();
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), count(), count());
+    m_rows.append(*m);
+    endInsertRows();
+    ++m_nextIndex;
+
+    emit countChanged();
+}
+
+void MessageListModel::onRequestRemoved(const QUuid& id)
+{
+    if (!m_conversationId.isNull() && id == m_conversationId) reload();
+}
@@ -0,0 +1,66 @@
+#ifndef MESSAGELISTMODEL_H
+#define MESSAGELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QUuid>
+#include <QVector>
+
+#include "message.h"
+
+// Сообщения одной беседы (чат заявки), по времени — снизу самые новые.
+// В отличие от остальных моделей хранит сами Message: старые страницы
+// читаются с диска и в памяти DataManager не остаются.
+// Открытие грузит одну страницу, loadOlder() — следующую в начало списка,
+// новые сообщения приходят по сигналу DataManager::commentAdded: номер сообщения
+// должен быть следующим после уже известных, иначе (пропуск) модель перечитывается.
+class MessageListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString conversationId READ conversationId WRITE setConversationId NOTIFY conversationIdChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(bool hasOlder READ hasOlder NOTIFY countChanged)
+
+public:
+    enum Roles {
+        ContentRole = Qt::UserRole + 1,
+        IsMeRole,
+        TimeRole,
+        MessageIdRole,
+        SenderIdRole,
+        TimestampRole
+    };
+
+    explicit MessageListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    QString conversationId() const { return m_conversationIdText; }
+    void setConversationId(const QString& id);
+    int count() const { return int(m_rows.size()); }
+    bool hasOlder() const { return m_hasOlder; }
+
+    // страница более старых сообщений в начало списка (прокрутка к верху)
+    Q_INVOKABLE void loadOlder();
+
+public slots:
+    void reload();
+    void onCommentAdded(const QString& requestId, int index);
+    void onRequestRemoved(const QUuid& id); // беседа удалена вместе с заявкой
+    void onCurrentUserChanged();
+
+signals:
+    void conversationIdChanged();
+    void countChanged();
+
+private:
+    QString m_conversationIdText;
+    QUuid m_conversationId;
+    QVector<Message> m_rows; // от старых к новым
+    bool m_hasOlder = false;
+    int m_nextIndex = 0; // номер следующего сообщения беседы
+};
+
+#endif // MESSAGELISTMODEL_H
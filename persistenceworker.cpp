@@ -0,0 +1,336 @@
+#include "persistenceworker.h"
+#include "storage.h"
+#include "catalogsnapshot.h"
+
+#include <QTimer>
+#include <QFile>
+#include <QDebug>
+#include <QMutexLocker>
+#include <QJsonArray>
+#include <QJsonDocument>
+
+// окно схлопывания: серия изменений за это время даёт одну запись
+static const int kCoalesceMs = 1000;
+
+template <typename T>
+static QJsonDocument toJsonArrayDocument(const QVector<T>& v)
+{
+    QJsonArray arr;
+    for (const auto& x : v)
+        arr.append(x.toJson());
+    return QJsonDocument(arr);
+}
+
+// Журнал после попытки записать снапшот. Снапшот записан — дописываются только
+// операции после него. Не записан — к старому журналу дописываются все операции,
+// а снапшот отбрасывается: старый снапшот + журнал согласованы, новый снапшот
+// сделает следующий checkpoint. Держать его в очереди нельзя: его запись очистит
+// журнал, и операции после coveredOps, уже лежащие в журнале, пропадут, а дописать
+// их повторно нельзя — не все операции идемпотентны.
+// Возвращает то, что нужно вернуть в очередь.
+template <typename T>
+static PendingJournal<T> finishJournal(const PendingJournal<T>& taken, bool snapshotWritten, Journal& journal)
+{
+    const bool lostSnapshot = taken.hasSnapshot && !snapshotWritten;
+
+    PendingJournal<T> left;
+    const QVector<QJsonObject> ops = (taken.hasSnapshot && snapshotWritten) ? taken.ops.mid(taken.coveredOps)
+                                                                            : taken.ops;
+    if (journal.append(ops)) return left;
+
+    // в журнал ничего не попало: операции ждут в очереди вместе с неудавшимся снапшотом
+    left.ops = ops;
+    if (lostSnapshot) {
+        left.snapshot = taken.snapshot;
+        left.hasSnapshot = true;
+        left.coveredOps = taken.coveredOps;
+    }
+    return left;
+}
+
+PersistenceWorker::PersistenceWorker(QObject* parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+    , m_servicesPath(servicesSnapshotFilePath())
+    , m_requestsPath(requestsFilePath())
+    , m_reviewsPath(reviewsFilePath())
+    , m_subscriptionsPath(subscriptionsFilePath())
+    , m_favoritesPath(favoritesFilePath())
+    , m_usersPath(usersFilePath())
+    , m_conversationsPath(conversationsFilePath())
+    , m_commentsPath(commentsJournalFilePath())
+    , m_requestsJournal(requestsJournalFilePath())
+    , m_usersJournal(usersJournalFilePath())
+    , m_conversationsJournal(conversationsJournalFilePath())
+{
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(kCoalesceMs);
+    connect(m_timer, &QTimer::timeout, this, &PersistenceWorker::writePending);
+}
+
+void PersistenceWorker::markDirty(int stores)
+{
+    m_dirty |= stores;
+    // таймер живёт в потоке воркера, поэтому запускаем его через очередь
+    QMetaObject::invokeMethod(this, "schedule", Qt::QueuedConnection);
+}
+
+void PersistenceWorker::submitServices(const CatalogData& catalog)
+{
+    QMutexLocker lock(&m_mutex);
+    m_services = catalog;
+    markDirty(StoreServices);
+}
+
+void PersistenceWorker::submitRequests(const QVector<Request>& requests)
+{
+    QMutexLocker lock(&m_mutex);
+    // ещё не записанные операции уже содержатся в снапшоте; из очереди они
+    // уходят только вместе с записанным снапшотом
+    m_requests.submit(requests);
+    markDirty(StoreRequests);
+}
+
+void PersistenceWorker::appendRequestOp(const QJsonObject& op)
+{
+    QMutexLocker lock(&m_mutex);
+    m_requests.ops.append(op);
+    markDirty(StoreRequestOps);
+}
+
+void PersistenceWorker::submitReviews(const QVector<Review>& reviews)
+{
+    QMutexLocker lock(&m_mutex);
+    m_reviews = reviews;
+    markDirty(StoreReviews);
+}
+
+void PersistenceWorker::submitSubscriptions(const QVector<Subscription>& subscriptions)
+{
+    QMutexLocker lock(&m_mutex);
+    m_subscriptions = subscriptions;
+    markDirty(StoreSubscriptions);
+}
+
+void PersistenceWorker::submitFavorites(const QVector<Favorites>& favorites)
+{
+    QMutexLocker lock(&m_mutex);
+    m_favorites = favorites;
+    markDirty(StoreFavorites);
+}
+
+void PersistenceWorker::submitUsers(const UserStore& users)
+{
+    QMutexLocker lock(&m_mutex);
+    // как и у заявок: снапшот уже включает незаписанные операции
+    m_users.submit(users);
+    markDirty(StoreUsers);
+}
+
+void PersistenceWorker::appendUserOp(const QJsonObject& op)
+{
+    QMutexLocker lock(&m_mutex);
+    m_users.ops.append(op);
+    markDirty(StoreUserOps);
+}
+
+void PersistenceWorker::submitConversations(const ConversationStore& conversations)
+{
+    QMutexLocker lock(&m_mutex);
+    m_conversations.submit(conversations);
+    markDirty(StoreConversations);
+}
+
+void PersistenceWorker::appendConversationOp(const QJsonObject& op)
+{
+    QMutexLocker lock(&m_mutex);
+    m_conversations.ops.append(op);
+    markDirty(StoreConversationOps);
+}
+
+void PersistenceWorker::appendMessage(const QString& conversationPath, const QJsonObject& record)
+{
+    QMutexLocker lock(&m_mutex);
+    m_messages[conversationPath].append(record);
+    markDirty(StoreMessages);
+}
+
+void PersistenceWorker::removeConversation(const QString& conversationPath)
+{
+    QMutexLocker lock(&m_mutex);
+    m_messages.remove(conversationPath);
+    m_removedConversations.insert(conversationPath);
+    markDirty(StoreMessages);
+}
+
+void PersistenceWorker::retireComments()
+{
+    QMutexLocker lock(&m_mutex);
+    m_retireComments = true;
+    markDirty(StoreMessages);
+}
+
+void PersistenceWorker::flush()
+{
+    writePending();
+}
+
+bool PersistenceWorker::flushMessages(const QString& conversationPath)
+{
+    QMutexLocker io(&m_ioMutex);
+
+    QVector<QJsonObject> records;
+    {
+        QMutexLocker lock(&m_mutex);
+        records = m_messages.take(conversationPath);
+    }
+    if (records.isEmpty() || Journal(conversationPath).append(records)) return true;
+
+    // не записалось — строки возвращаются в очередь перед пришедшими позже
+    QMutexLocker lock(&m_mutex);
+    QVector<QJsonObject>& pending = m_messages[conversationPath];
+    pending = records + pending;
+    markDirty(StoreMessages);
+    return false;
+}
+
+void PersistenceWorker::schedule()
+{
+    if (!m_timer->isActive())
+        m_timer->start();
+}
+
+void PersistenceWorker::writePending()
+{
+    QMutexLocker io(&m_ioMutex);
+
+    int dirty = 0;
+    CatalogData services;
+    PendingJournal<QVector<Request>> requests;
+    QVector<Review> reviews;
+    QVector<Subscription> subscriptions;
+    QVector<Favorites> favorites;
+    PendingJournal<UserStore> users;
+    PendingJournal<ConversationStore> conversations;
+    QHash<QString, QVector<QJsonObject>> messages;
+    QSet<QString> removedConversations;
+    bool retiring = false; // перенос комментариев ждёт файлов бесед
+
+    {
+        // забираем снапшоты и отпускаем ссылки, чтобы GUI-поток не копировал данные при следующей мутации
+        QMutexLocker lock(&m_mutex);
+        dirty = m_dirty;
+        m_dirty = 0;
+        retiring = m_retireComments;
+
+        if (dirty & StoreServices)      { services = m_services;           m_services = CatalogData(); }
+        if (dirty & (StoreRequests | StoreRequestOps)) { requests = m_requests; m_requests = PendingJournal<QVector<Request>>(); }
+        if (dirty & StoreReviews)       { reviews = m_reviews;             m_reviews.clear(); }
+        if (dirty & StoreSubscriptions) { subscriptions = m_subscriptions; m_subscriptions.clear(); }
+        if (dirty & StoreFavorites)     { favorites = m_favorites;         m_favorites.clear(); }
+        if (dirty & (StoreUsers | StoreUserOps)) { users = m_users;        m_users = PendingJournal<UserStore>(); }
+        if (dirty & (StoreConversations | StoreConversationOps)) {
+            conversations = m_conversations;
+            m_conversations = PendingJournal<ConversationStore>();
+        }
+        if (dirty & StoreMessages) {
+            messages = m_messages;
+            m_messages.clear();
+            removedConversations = m_removedConversations;
+            m_removedConversations.clear();
+        }
+    }
+
+    if (dirty == 0) return;
+
+    int failed = 0;
+    if ((dirty & StoreServices) && !CatalogSnapshot::write(services, m_servicesPath))
+        failed |= StoreServices;
+
+    // сообщения раньше заявок: перенесённые в беседы комментарии должны оказаться
+    // на диске до снапшота заявок, который их уже не содержит
+    QHash<QString, QVector<QJsonObject>> messagesLeft;
+    for (auto it = messages.constBegin(); it != messages.constEnd(); ++it) {
+        if (!Journal(it.key()).append(it.value()))
+            messagesLeft.insert(it.key(), it.value());
+    }
+    QSet<QString> removedLeft;
+    for (const auto& path : removedConversations) {
+        if (QFile::exists(path) && !QFile::remove(path))
+            removedLeft.insert(path);
+    }
+    const bool commentsRetired = retiring && messagesLeft.isEmpty()
+                                 && (!QFile::exists(m_commentsPath) || QFile::remove(m_commentsPath));
+    if (commentsRetired) {
+        QMutexLocker lock(&m_mutex);
+        m_retireComments = false;
+    }
+
+    // checkpoint: сначала снапшот, потом очистка журнала, потом операции после снапшота.
+    // Пока перенос комментариев не записан, старый снапшот + журнал остаются источником
+    // истины: операции дописываются к журналу, а снапшот отбрасывается до следующего checkpoint
+    bool requestsWritten = false;
+    if (requests.hasSnapshot && (!retiring || commentsRetired)) {
+        requestsWritten = writeJsonFile(m_requestsPath, toJsonArrayDocument(requests.snapshot));
+        if (requestsWritten) m_requestsJournal.clear();
+    }
+    const PendingJournal<QVector<Request>> requestsLeft = finishJournal(requests, requestsWritten, m_requestsJournal);
+
+    if ((dirty & StoreReviews) && !writeJsonFile(m_reviewsPath, toJsonArrayDocument(reviews)))
+        failed |= StoreReviews;
+    if ((dirty & StoreSubscriptions) && !writeJsonFile(m_subscriptionsPath, toJsonArrayDocument(subscriptions)))
+        failed |= StoreSubscriptions;
+    if ((dirty & StoreFavorites) && !writeJsonFile(m_favoritesPath, toJsonArrayDocument(favorites)))
+        failed |= StoreFavorites;
+
+    bool usersWritten = false;
+    if (users.hasSnapshot) {
+        usersWritten = writeJsonFile(m_usersPath, QJsonDocument(users.snapshot.toJson()));
+        if (usersWritten) m_usersJournal.clear();
+    }
+    const PendingJournal<UserStore> usersLeft = finishJournal(users, usersWritten, m_usersJournal);
+
+    // метаданные после сообщений: счётчики на диске не обгоняют файлы бесед
+    bool conversationsWritten = false;
+    if (conversations.hasSnapshot) {
+        conversationsWritten = writeJsonFile(m_conversationsPath, QJsonDocument(conversations.snapshot.toJson()));
+        if (conversationsWritten) m_conversationsJournal.clear();
+    }
+    const PendingJournal<ConversationStore> conversationsLeft
+        = finishJournal(conversations, conversationsWritten, m_conversationsJournal);
+
+    if (failed == 0 && (!retiring || commentsRetired) && requestsLeft.isEmpty()
+        && usersLeft.isEmpty() && conversationsLeft.isEmpty()
+        && messagesLeft.isEmpty() && removedLeft.isEmpty())
+        return;
+
+    qWarning() << "PersistenceWorker: write failed, will retry";
+
+    // вернуть несостоявшееся в очередь; более новый снапшот того же хранилища важнее
+    QMutexLocker lock(&m_mutex);
+    int retry = 0;
+    if ((failed & StoreServices) && !(m_dirty & StoreServices)) { m_services = services; retry |= StoreServices; }
+    if ((failed & StoreReviews) && !(m_dirty & StoreReviews)) { m_reviews = reviews; retry |= StoreReviews; }
+    if ((failed & StoreSubscriptions) && !(m_dirty & StoreSubscriptions)) { m_subscriptions = subscriptions; retry |= StoreSubscriptions; }
+    if ((failed & StoreFavorites) && !(m_dirty & StoreFavorites)) { m_favorites = favorites; retry |= StoreFavorites; }
+
+    if (retiring && !commentsRetired) retry |= StoreMessages;
+    if (!requestsLeft.isEmpty()) { m_requests.restore(requestsLeft); retry |= StoreRequests | StoreRequestOps; }
+    if (!usersLeft.isEmpty())    { m_users.restore(usersLeft);       retry |= StoreUsers | StoreUserOps; }
+    if (!conversationsLeft.isEmpty()) {
+        m_conversations.restore(conversationsLeft);
+        retry |= StoreConversations | StoreConversationOps;
+    }
+
+    for (auto it = messagesLeft.constBegin(); it != messagesLeft.constEnd(); ++it) {
+        QVector<QJsonObject>& pending = m_messages[it.key()];
+        pending = it.value() + pending;
+        retry |= StoreMessages;
+    }
+    if (!removedLeft.isEmpty()) {
+        m_removedConversations.unite(removedLeft);
+        retry |= StoreMessages;
+    }
+
+    if (retry) markDirty(retry);
+}
@@ -0,0 +1,147 @@
+#ifndef PERSISTENCEWORKER_H
+#define PERSISTENCEWORKER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QVector>
+#include <QSet>
+#include <QJsonObject>
+
+#include "catalogsnapshot.h"
+#include "request.h"
+#include "review.h"
+#include "subscription.h"
+#include "favorites.h"
+#include "userstore.h"
+#include "conversationstore.h"
+#include "journal.h"
+
+class QTimer;
+
+// Снапшот + хвост журнала одного хранилища в очереди на запись.
+// Снапшот включает первые coveredOps операций: после его записи в журнал
+// идут только остальные. Несостоявшаяся запись возвращается через restore():
+// снапшот — только вместе с операциями, которые так и не попали в журнал.
+template <typename T>
+struct PendingJournal
+{
+    T snapshot;
+    bool hasSnapshot = false;
+    QVector<QJsonObject> ops;
+    int coveredOps = 0;
+
+    bool isEmpty() const { return !hasSnapshot && ops.isEmpty(); }
+
+    void submit(const T& s)
+    {
+        snapshot = s;
+        hasSnapshot = true;
+        coveredOps = int(ops.size());
+    }
+
+    // failed старше всего, что накопилось за время записи
+    void restore(const PendingJournal& failed)
+    {
+        if (failed.isEmpty()) return;
+        if (hasSnapshot) {
+            coveredOps += int(failed.ops.size()); // более новый снапшот покрывает и их
+        } else if (failed.hasSnapshot) {
+            snapshot = failed.snapshot;
+            hasSnapshot = true;
+            coveredOps = failed.coveredOps;
+        }
+        ops = failed.ops + ops;
+    }
+};
+
+// Фоновая запись хранилищ на диск.
+// GUI-поток только отдаёт снапшоты (копии implicitly shared контейнеров — O(1)),
+// сериализация и I/O идут в потоке воркера. Повторные submit в пределах
+// окна kCoalesceMs схлопываются в одну запись последнего снапшота.
+// Неудачная запись не теряет данных: операции, не попавшие в журнал, возвращаются
+// в очередь (если их не вытеснил более новый снапшот), попытка повторяется по таймеру.
+// Снапшот, не записанный при дописанном журнале, отбрасывается до следующего checkpoint.
+class PersistenceWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Store {
+        StoreServices      = 0x01,
+        StoreRequests      = 0x02,   // полный снапшот requests.json (checkpoint)
+        StoreRequestOps    = 0x04,   // хвост журнала requests.journal
+        StoreReviews       = 0x08,
+        StoreSubscriptions = 0x10,
+        StoreFavorites     = 0x20,
+        StoreUsers         = 0x40,   // полный снапшот users.json (checkpoint)
+        StoreUserOps       = 0x80,   // хвост журнала users.journal
+        StoreConversations = 0x400,  // полный снапшот conversations.json (checkpoint)
+        StoreMessages      = 0x800,  // хвосты файлов бесед
+        StoreConversationOps = 0x1000 // хвост журнала conversations.journal
+    };
+
+    explicit PersistenceWorker(QObject* parent = nullptr);
+
+    // --- вызываются из GUI-потока ---
+    void submitServices(const CatalogData& catalog);
+    void submitRequests(const QVector<Request>& requests);
+    void appendRequestOp(const QJsonObject& op);
+    void submitReviews(const QVector<Review>& reviews);
+    void submitSubscriptions(const QVector<Subscription>& subscriptions);
+    void submitFavorites(const QVector<Favorites>& favorites);
+    void submitUsers(const UserStore& users);
+    void appendUserOp(const QJsonObject& op);
+    void submitConversations(const ConversationStore& conversations);
+    void appendConversationOp(const QJsonObject& op);
+    void appendMessage(const QString& conversationPath, const QJsonObject& record);
+    void removeConversation(const QString& conversationPath); // недописанные строки отбрасываются
+    // комментарии старых форматов перенесены в файлы бесед (appendMessage): когда все
+    // строки бесед окажутся на диске, comments.journal удаляется, а до того снапшот
+    // заявок (уже без комментариев внутри) не пишется — старые источники нужны для повтора
+    void retireComments();
+
+    // синхронно записать всё накопленное (shutdown, тесты); безопасно из любого потока
+    void flush();
+    // синхронно дописать только строки одной беседы — перед чтением её файла
+    bool flushMessages(const QString& conversationPath);
+
+private slots:
+    void schedule();
+    void writePending();
+
+private:
+    void markDirty(int stores);
+
+private:
+    QTimer* m_timer = nullptr;
+
+    // пути фиксируются при создании: при shutdown QStandardPaths уже может не знать имя приложения
+    QString m_servicesPath;
+    QString m_requestsPath;
+    QString m_reviewsPath;
+    QString m_subscriptionsPath;
+    QString m_favoritesPath;
+    QString m_usersPath;
+    QString m_conversationsPath;
+    QString m_commentsPath;  // старый comments.journal, только удаляется
+    Journal m_requestsJournal;
+    Journal m_usersJournal;
+    Journal m_conversationsJournal;
+
+    QMutex m_ioMutex;   // одна запись на диск за раз (таймер воркера vs flush())
+
+    QMutex m_mutex;     // защищает всё ниже
+    int m_dirty = 0;
+    CatalogData m_services;
+    PendingJournal<QVector<Request>> m_requests;
+    bool m_retireComments = false;           // перенос комментариев ещё не на диске
+    QVector<Review> m_reviews;
+    QVector<Subscription> m_subscriptions;
+    QVector<Favorites> m_favorites;
+    PendingJournal<UserStore> m_users;
+    PendingJournal<ConversationStore> m_conversations;
+    QHash<QString, QVector<QJsonObject>> m_messages; // файл беседы -> новые строки
+    QSet<QString> m_removedConversations;           // файлы бесед к удалению
+};
+
+#endif // PERSISTENCEWORKER_H
@@ -0,0 +1,62 @@
+#ifndef RANKINDEX_H
+#define RANKINDEX_H
+
+#include <QDateTime>
+#include <QMap>
+#include <QPair>
+#include <QUuid>
+#include <QVector>
+#include <limits>
+
+// Упорядоченный индекс (ключ, id) для top-K без сортировки всего хранилища.
+// При равных ключах порядок определяется id. Ключ в remove должен совпадать
+// с тем, что был передан в insert.
+template <typename K>
+class RankIndex
+{
+public:
+    typedef typename QMap<QPair<K, QUuid>, bool>::const_iterator const_iterator;
+
+    void clear() { m_entries.clear(); }
+    int size() const { return int(m_entries.size()); }
+
+    void insert(const K& key, const QUuid& id) { m_entries.insert(qMakePair(key, id), true); }
+    void remove(const K& key, const QUuid& id) { m_entries.remove(qMakePair(key, id)); }
+
+    // обход по возрастанию ключа; id записи — it.key().second
+    const_iterator begin() const { return m_entries.constBegin(); }
+    const_iterator end() const { return m_entries.constEnd(); }
+
+    // позиции для keyset-курсора: первая запись >= / > (key, id)
+    const_iterator lowerBound(const K& key, const QUuid& id) const { return m_entries.lowerBound(qMakePair(key, id)); }
+    const_iterator upperBound(const K& key, const QUuid& id) const { return m_entries.upperBound(qMakePair(key, id)); }
+
+    // id по убыванию ключа, не больше count
+    QVector<QUuid> top(int count) const
+    {
+        QVector<QUuid> out;
+        if (count <= 0) return out;
+        out.reserve(qMin(count, size()));
+
+        auto it = m_entries.constEnd();
+        while (it != m_entries.constBegin() && out.size() < count) {
+            --it;
+            out.append(it.key().second);
+        }
+        return out;
+    }
+
+private:
+    QMap<QPair<K, QUuid>, bool> m_entries;
+};
+
+// ключ RankIndex по времени создания (getCreatedAt); записи без даты — самые старые.
+// Общий для индексов DataManager и моделей, которые держат ключи строк
+template <typename T>
+inline qint64 createdKey(const T& item)
+{
+    const QDateTime dt = item.getCreatedAt();
+    return dt.isValid() ? dt.toMSecsSinceEpoch() : std::numeric_limits<qint64>::min();
+}
+
+#endif // RANKINDEX_H
@@ -0,0 +1,63 @@
+#ifndef RATINGAGGREGATE_H
+#define RATINGAGGREGATE_H
+
+#include <QVariantMap>
+#include <QVariantList>
+#include <QtGlobal>
+
+// Сводка оценок (1..5) услуги или исполнителя, обновляется по одному отзыву за O(1).
+// score — байесовское сглаживание: к оценкам добавляются kPriorWeight «виртуальных»
+// оценок kPriorMean, поэтому одна пятёрка не обгоняет сотню четвёрок.
+// Без отзывов score == kPriorMean, но рейтинг услуги в каталоге тогда не трогается:
+// сводка заменяет его только начиная с первого отзыва.
+struct RatingAggregate
+{
+    static constexpr double kPriorMean = 3.0;
+    static constexpr int kPriorWeight = 5;
+
+    int count = 0;
+    double sum = 0.0;
+    int histogram[5] = {0, 0, 0, 0, 0}; // histogram[i] — число оценок i + 1
+
+    static int starOf(double rating) { return qBound(1, qRound(rating), 5); }
+
+    void add(double rating)
+    {
+        ++count;
+        sum += rating;
+        ++histogram[starOf(rating) - 1];
+    }
+
+    void merge(const RatingAggregate& other)
+    {
+        count += other.count;
+        sum += other.sum;
+        for (int i = 0; i < 5; ++i) histogram[i] += other.histogram[i];
+    }
+
+    void subtract(const RatingAggregate& other)
+    {
+        count -= other.count;
+        sum -= other.sum;
+        for (int i = 0; i < 5; ++i) histogram[i] -= other.histogram[i];
+    }
+
+    double mean() const { return count > 0 ? sum / count : 0.0; }
+    double score() const { return (kPriorMean * kPriorWeight + sum) / (kPriorWeight + count); }
+
+    QVariantMap toVariantMap() const
+    {
+        QVariantList hist;
+        for (int i = 0; i < 5; ++i) hist.append(histogram[i]);
+
+        QVariantMap out;
+        out["count"] = count;
+        out["sum"] = sum;
+        out["mean"] = mean();
+        out["score"] = score();
+        out["histogram"] = hist;
+        return out;
+    }
+};
+
+#endif // RATINGAGGREGATE_H
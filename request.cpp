@@ -32,15 +32,6 @@ void Request::updateStatus(Status newStatus)
         m_completedAt = QDateTime::currentDateTime();
 }
 
-void Request::addComment(const QString &comment)
-{
-    const QString c = comment.trimmed();
-    if (c.isEmpty())
-        return;
-
-    m_comments.append(c);
-}
-
 QString Request::getStatusString() const
 {
     switch (m_status) {
@@ -91,8 +82,7 @@ QString Request::getFullInfo() const
                "status: %5\n"
                "description: %6\n"
                "createdAt: %7\n"
-               "completedAt: %8\n"
-               "comments: %9\n")
+               "completedAt: %8\n")
         .arg(m_id.toString(QUuid::WithoutBraces))
         .arg(m_serviceId.toString(QUuid::WithoutBraces))
         .arg(m_clientId.toString(QUuid::WithoutBraces))
@@ -100,8 +90,7 @@ QString Request::getFullInfo() const
         .arg(getStatusString())
         .arg(m_description)
         .arg(m_createdAt.toString(Qt::ISODate))
-        .arg(m_completedAt.isValid() ? m_completedAt.toString(Qt::ISODate) : QString())
-        .arg(m_comments.size());
+        .arg(m_completedAt.isValid() ? m_completedAt.toString(Qt::ISODate) : QString());
 }
 
 QJsonObject Request::toJson() const
@@ -120,11 +109,6 @@ QJsonObject Request::toJson() const
     json["createdAt"] = m_createdAt.toString(Qt::ISODate);
     json["completedAt"] = m_completedAt.isValid() ? m_completedAt.toString(Qt::ISODate) : QString();
 
-    QJsonArray commentsArray;
-    for (const QString &c : m_comments)
-        commentsArray.append(c);
-    json["comments"] = commentsArray;
-
     return json;
 }
 
@@ -153,13 +137,6 @@ Request Request::fromJson(const QJsonObject &json)
 
     r.m_completedAt = QDateTime::fromString(json.value("completedAt").toString(), Qt::ISODate);
 
-    const QJsonArray commentsArray = json.value("comments").toArray();
-    for (const QJsonValue &v : commentsArray) {
-        const QString c = v.toString().trimmed();
-        if (!c.isEmpty())
-            r.m_comments.append(c);
-    }
-
     // если пришёл Completed, но completedAt пустой — можно восстановить по createdAt (или "сейчас")
     if (r.m_status == Status::Completed && !r.m_completedAt.isValid())
         r.m_completedAt = r.m_createdAt;
@@ -3,10 +3,8 @@
 
 #include <QUuid>
 #include <QString>
-#include <QStringList>
 #include <QDateTime>
 #include <QJsonObject>
-#include <QJsonArray>
 
 class Request
 {
@@ -39,12 +37,12 @@ public:
     QDateTime getCreatedAt() const { return m_createdAt; }
     QDateTime getCompletedAt() const { return m_completedAt; }
 
-    QStringList getComments() const { return m_comments; }
-
     // Setters
     void setDescription(const QString &description);
     void updateStatus(Status newStatus);
-    void addComment(const QString &comment);
+
+    // для воспроизведения журнала: completedAt берётся из записи, а не "сейчас"
+    void setCompletedAt(const QDateTime &dt) { m_completedAt = dt; }
 
     // Для DataManager
     void setStatusFromInt(int index) {
@@ -79,7 +77,7 @@ private:
     QDateTime m_createdAt;
     QDateTime m_completedAt;
 
-    QStringList m_comments;
+    // комментарии — сообщения беседы заявки (ConversationStore)
 };
 
 #endif // REQUEST_H
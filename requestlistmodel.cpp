@@ -0,0 +1,241 @@
+#include "requestlistmodel.h"
+#include "datamanager.h"
+#include "request.h"
+#include "rankindex.h"
+
+// порядок строк: createdAt по убыванию, при равенстве id по убыванию
+static bool precedes(qint64 keyA, const QUuid& idA, qint64 keyB, const QUuid& idB)
+{
+    if (keyA != keyB) return keyA > keyB;
+    return idB < idA;
+}
+
+RequestListModel::RequestListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    DataManager* dm = &DataManager::instance();
+    connect(dm, &DataManager::requestsReset, this, &RequestListModel::reload);
+    connect(dm, &DataManager::requestAdded, this, &RequestListModel::onRequestAdded);
+    connect(dm, &DataManager::requestUpdated, this, &RequestListModel::onRequestUpdated);
+    connect(dm, &DataManager::requestRemoved, this, &RequestListModel::onRequestRemoved);
+    // commentCount / lastComment берутся из бесед, а они грузятся отдельно
+    connect(dm, &DataManager::conversationsReset, this, &RequestListModel::onConversationsReset);
+
+    reload();
+}
+
+int RequestListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant RequestListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size()) return QVariant();
+
+    const Request* r = DataManager::instance().findRequest(m_rows[index.row()]);
+    if (!r) return QVariant();
+
+    switch (role) {
+    case IdRole:          return r->getId().toString(QUuid::WithoutBraces);
+    case ServiceIdRole:   return r->getServiceId().toString(QUuid::WithoutBraces);
+    case ClientIdRole:    return r->getClientId().toString(QUuid::WithoutBraces);
+    case ProviderIdRole:  return r->getProviderId().toString(QUuid::WithoutBraces);
+    case StatusRole:      return r->getStatusIndex();
+    case Qt::DisplayRole:
+    case DescriptionRole: return r->getDescription();
+    case CreatedAtRole:   return r->getCreatedAt().toString(Qt::ISODate);
+    case CompletedAtRole: return r->getCompletedAt().isValid() ? r->getCompletedAt().toString(Qt::ISODate) : QString();
+    case CommentCountRole: return DataManager::instance().commentCount(r->getId());
+    case LastCommentRole: {
+        const Message* m = DataManager::instance().lastComment(r->getId());
+        return m ? m->getContent() : QString();
+    }
+    case LastCommentAtRole: {
+        const Message* m = DataManager::instance().lastComment(r->getId());
+        return m ? m->getTimestamp().toString(Qt::ISODate) : QString();
+    }
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> RequestListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[IdRole] = "id";
+    roles[ServiceIdRole] = "serviceId";
+    roles[ClientIdRole] = "clientId";
+    roles[ProviderIdRole] = "providerId";
+    roles[StatusRole] = "status";
+    roles[DescriptionRole] = "description";
+    roles[CreatedAtRole] = "createdAt";
+    roles[CompletedAtRole] = "completedAt";
+    roles[CommentCountRole] = "commentCount";
+    roles[LastCommentRole] = "lastComment";
+    roles[LastCommentAtRole] = "lastCommentAt";
+    return roles;
+}
+
+// ---------------- filters ----------------
+void RequestListModel::setClientFilter(const QString& id)
+{
+    if (id == m_clientFilter) return;
+    m_clientFilter = id;
+    m_clientId = QUuid(id.trimmed());
+    reload();
+    emit filterChanged();
+}
+
+void RequestListModel::setProviderFilter(const QString& id)
+{
+    if (id == m_providerFilter) return;
+    m_providerFilter = id;
+    m_providerId = QUuid(id.trimmed());
+    reload();
+    emit filterChanged();
+}
+
+void RequestListModel::setStatusFilter(int status)
+{
+    if (status < 0) status = -1;
+    if (status == m_statusFilter) return;
+    m_statusFilter = status;
+    reload();
+    emit filterChanged();
+}
+
+bool RequestListModel::accepts(const Request& r) const
+{
+    if (!m_clientFilter.trimmed().isEmpty() && r.getClientId() != m_clientId) return false;
+    if (!m_providerFilter.trimmed().isEmpty() && r.getProviderId() != m_providerId) return false;
+    if (m_statusFilter >= 0 && r.getStatusIndex() != m_statusFilter) return false;
+    return true;
+}
+
+void RequestListModel::reload()
+{
+    // индексы DataManager сужают выборку, accepts() остаётся окончательной проверкой
+    RequestQuery q;
+    q.clientId = m_clientId;
+    q.providerId = m_providerId;
+    q.statusMask = RequestQuery::statusBit(m_statusFilter);
+
+    const DataManager& dm = DataManager::instance();
+    const QVector<QUuid> ids = dm.queryRequestIds(q);
+
+    beginResetModel();
+    m_rows.clear();
+    m_keys.clear();
+    m_keyOf.clear();
+    for (const auto& id : ids) {
+        const Request* r = dm.findRequest(id);
+        if (!r || !accepts(*r)) continue;
+        const qint64 key = createdKey(*r);
+        m_rows.append(id);
+        m_keys.append(key);
+        m_keyOf.insert(id, key);
+    }
+    endResetModel();
+
+    emit countChanged();
+}
+
+// ---------------- row helpers ----------------
+int RequestListModel::rowOf(const QUuid& id) const
+{
+    const auto it = m_keyOf.constFind(id);
+    if (it == m_keyOf.constEnd()) return -1;
+
+    const int row = insertPosition(it.value(), id);
+    return (row < m_rows.size() && m_rows[row] == id) ? row : -1;
+}
+
+int RequestListModel::insertPosition(qint64 key, const QUuid& id) const
+{
+    int lo = 0;
+    int hi = int(m_rows.size());
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (precedes(m_keys[mid], m_rows[mid], key, id)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// ---------------- DataManager changes ----------------
+void RequestListModel::onRequestAdded(const QUuid& id)
+{
+    if (rowOf(id) >= 0) return;
+
+    const Request* r = DataManager::instance().findRequest(id);
+    if (!r || !accepts(*r)) return;
+
+    const qint64 key = createdKey(*r);
+    const int pos = insertPosition(key, id);
+
+    beginInsertRows(QModelIndex(), pos, pos);
+    m_rows.insert(pos, id);
+    m_keys.insert(pos, key);
+    m_keyOf.insert(id, key);
+    endInsertRows();
+
+    emit countChanged();
+}
+
+void RequestListModel::onRequestUpdated(const QUuid& id)
+{
+    const Request* r = DataManager::instance().findRequest(id);
+    const int row = rowOf(id);
+
+    // смена статуса может вывести заявку из фильтра или ввести в него
+    if (!r || !accepts(*r)) {
+        onRequestRemoved(id);
+        return;
+    }
+    if (row < 0) {
+        onRequestAdded(id);
+        return;
+    }
+
+    const QModelIndex idx = index(row);
+    emit dataChanged(idx, idx);
+}
+
+void RequestListModel::onRequestRemoved(const QUuid& id)
+{
+    const int row = rowOf(id);
+    if (row < 0) return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rows.removeAt(row);
+    m_keys.removeAt(row);
+    m_keyOf.remove(id);
+    endRemoveRows();
+
+    emit countChanged();
+}
+
+void RequestListModel::onConversationsReset()
+{
+    if (m_rows.isEmpty()) return;
+    emit dataChanged(index(0), index(count() - 1), { CommentCountRole, LastCommentRole, LastCommentAtRole });
+}
+
+// ---------------- QML helpers ----------------
+QVariantMap RequestListModel::get(int row) const
+{
+    QVariantMap out;
+    if (row < 0 || row >= m_rows.size()) return out;
+
+    const QHash<int, QByteArray> roles = roleNames();
+    for (auto it = roles.constBegin(); it != roles.constEnd(); ++it)
+        out[QString::fromUtf8(it.value())] = data(index(row), it.key());
+    return out;
+}
+
+int RequestListModel::indexOf(const QString& requestId) const
+{
+    const QUuid id(requestId.trimmed());
+    return id.isNull() ? -1 : rowOf(id);
+}
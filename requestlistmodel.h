@@ -0,0 +1,87 @@
+#ifndef REQUESTLISTMODEL_H
+#define REQUESTLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QVector>
+#include <QUuid>
+#include <QVariantMap>
+
+class Request;
+
+// Заявки для QML, от новых к старым, с фильтром по клиенту / исполнителю / статусу.
+// Хранит только id строк; изменения DataManager приходят точечно:
+// правка заявки -> dataChanged одной строки, создание/удаление -> вставка/удаление строки,
+// поэтому выделение в ListView не сбрасывается.
+class RequestListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    // пустая строка / -1 — без фильтра
+    Q_PROPERTY(QString clientFilter READ clientFilter WRITE setClientFilter NOTIFY filterChanged)
+    Q_PROPERTY(QString providerFilter READ providerFilter WRITE setProviderFilter NOTIFY filterChanged)
+    Q_PROPERTY(int statusFilter READ statusFilter WRITE setStatusFilter NOTIFY filterChanged)
+
+public:
+    // роли совпадают с полями прежнего ListModel requestListModel в main.qml
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        ServiceIdRole,
+        ClientIdRole,
+        ProviderIdRole,
+        StatusRole,
+        DescriptionRole,
+        CreatedAtRole,
+        CompletedAtRole,
+        CommentCountRole,    // сами комментарии — в чате заявки (MessageListModel)
+        LastCommentRole,
+        LastCommentAtRole
+    };
+
+    explicit RequestListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int count() const { return int(m_rows.size()); }
+
+    QString clientFilter() const { return m_clientFilter; }
+    QString providerFilter() const { return m_providerFilter; }
+    int statusFilter() const { return m_statusFilter; }
+    void setClientFilter(const QString& id);
+    void setProviderFilter(const QString& id);
+    void setStatusFilter(int status);
+
+    Q_INVOKABLE QVariantMap get(int row) const;
+    Q_INVOKABLE int indexOf(const QString& requestId) const;
+
+public slots:
+    void reload();
+    void onRequestAdded(const QUuid& id);
+    void onRequestUpdated(const QUuid& id);
+    void onRequestRemoved(const QUuid& id);
+    void onConversationsReset(); // роли комментариев всех строк
+
+signals:
+    void countChanged();
+    void filterChanged();
+
+private:
+    bool accepts(const Request& r) const;
+    int rowOf(const QUuid& id) const; // O(log n): ключ из m_keyOf + бинарный поиск
+    int insertPosition(qint64 key, const QUuid& id) const;
+
+private:
+    QString m_clientFilter;
+    QString m_providerFilter;
+    QUuid m_clientId;
+    QUuid m_providerId;
+    int m_statusFilter = -1;
+
+    QVector<QUuid> m_rows;
+    QVector<qint64> m_keys; // createdAt, мс — позиция вставки
+    QHash<QUuid, qint64> m_keyOf; // id -> ключ: без поправки номеров строк при вставке
+};
+
+#endif // REQUESTLISTMODEL_H
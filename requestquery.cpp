@@ -0,0 +1,40 @@
+#include "requestquery.h"
+#include "request.h"
+
+int RequestQuery::openStatusMask()
+{
+    return statusBit(int(Request::Status::Pending))
+         | statusBit(int(Request::Status::Accepted))
+         | statusBit(int(Request::Status::InProgress));
+}
+
+bool RequestQuery::matches(const Request& r) const
+{
+    if (!clientId.isNull() && r.getClientId() != clientId) return false;
+    if (!providerId.isNull() && r.getProviderId() != providerId) return false;
+    if (!serviceId.isNull() && r.getServiceId() != serviceId) return false;
+    return hasStatus(r.getStatusIndex());
+}
+
+RequestQuery RequestQuery::fromVariantMap(const QVariantMap& m)
+{
+    RequestQuery q;
+    q.clientId = QUuid(m.value("clientId").toString().trimmed());
+    q.providerId = QUuid(m.value("providerId").toString().trimmed());
+    q.serviceId = QUuid(m.value("serviceId").toString().trimmed());
+    q.limit = m.value("limit", -1).toInt();
+
+    const QVariant status = m.value("status");
+    if (status.typeId() == QMetaType::QVariantList) {
+        const QVariantList list = status.toList();
+        for (const auto& s : list)
+            q.statusMask |= statusBit(s.toInt());
+    } else if (status.isValid()) {
+        q.statusMask = statusBit(status.toInt()); // -1 -> 0, без условия
+    }
+    // open — сокращение для "ещё не закрыта"; явный status важнее
+    if (q.statusMask == 0 && m.value("open").toBool())
+        q.statusMask = openStatusMask();
+
+    return q;
+}
@@ -0,0 +1,36 @@
+#ifndef REQUESTQUERY_H
+#define REQUESTQUERY_H
+
+#include <QUuid>
+#include <QVariantMap>
+
+class Request;
+
+// Выборка заявок по вторичным индексам DataManager: все условия через AND,
+// порядок — от новых к старым (createdAt, затем id). Нулевой id — без условия.
+struct RequestQuery
+{
+    QUuid clientId;
+    QUuid providerId;
+    QUuid serviceId;
+    int statusMask = 0; // бит (1 << Request::Status); 0 — любой статус
+
+    int limit = -1;     // < 0 — без ограничения
+
+    // keyset-курсор: только заявки строго старше (afterKey, afterId)
+    bool hasAfter = false;
+    qint64 afterKey = 0;
+    QUuid afterId;
+
+    static int statusBit(int status) { return (status >= 0 && status < 31) ? (1 << status) : 0; }
+    static int openStatusMask();   // Pending | Accepted | InProgress
+
+    bool hasStatus(int status) const { return statusMask == 0 || (statusMask & statusBit(status)); }
+    bool matches(const Request& r) const;
+
+    // из QML: {clientId, providerId, serviceId, status: int | [int], open: bool, limit};
+    // mine и after разбирает DataManager::queryRequests
+    static RequestQuery fromVariantMap(const QVariantMap& m);
+};
+
+#endif // REQUESTQUERY_H
@@ -0,0 +1,148 @@
+#include "reviewlistmodel.h"
+#include "datamanager.h"
+#include "review.h"
+#include "rankindex.h"
+
+#include <limits>
+
+static const int kPageSize = 50;
+
+// порядок строк: createdAt по убыванию, при равенстве id по убыванию
+static bool precedes(qint64 keyA, const QUuid& idA, qint64 keyB, const QUuid& idB)
+{
+    if (keyA != keyB) return keyA > keyB;
+    return idB < idA;
+}
+
+ReviewListModel::ReviewListModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    DataManager* dm = &DataManager::instance();
+    connect(dm, &DataManager::reviewsReset, this, &ReviewListModel::reload);
+    connect(dm, &DataManager::reviewAdded, this, &ReviewListModel::onReviewAdded);
+}
+
+int ReviewListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant ReviewListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size()) return QVariant();
+
+    const Review* r = DataManager::instance().findReview(m_rows[index.row()]);
+    if (!r) return QVariant();
+
+    switch (role) {
+    case AuthorIdRole:  return r->getClientId().toString(QUuid::WithoutBraces);
+    case RatingRole:    return r->getRating();
+    case Qt::DisplayRole:
+    case CommentRole:   return r->getComment();
+    case CreatedAtRole: return r->getCreatedAt().toString(Qt::ISODate);
+    default:            return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ReviewListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[AuthorIdRole] = "authorId";
+    roles[RatingRole] = "rating";
+    roles[CommentRole] = "comment";
+    roles[CreatedAtRole] = "createdAt";
+    return roles;
+}
+
+int ReviewListModel::total() const
+{
+    return DataManager::instance().getReviewCount(m_serviceIdText);
+}
+
+void ReviewListModel::setServiceId(const QString& id)
+{
+    if (id == m_serviceIdText) return;
+    m_serviceIdText = id;
+    m_serviceId = QUuid(id.trimmed());
+    reload();
+    emit serviceIdChanged();
+}
+
+// ---------------- paging ----------------
+bool ReviewListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_hasMore;
+}
+
+void ReviewListModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || !m_hasMore) return;
+    fetchPage();
+}
+
+void ReviewListModel::fetchPage()
+{
+    const DataManager& dm = DataManager::instance();
+    const QUuid after = m_rows.isEmpty() ? QUuid() : m_rows.last();
+    const QVector<QUuid> page = dm.reviewIdsNewestFirst(m_serviceId, kPageSize, after);
+
+    m_hasMore = (page.size() == kPageSize);
+    if (page.isEmpty()) return;
+
+    const int first = int(m_rows.size());
+    beginInsertRows(QModelIndex(), first, first + int(page.size()) - 1);
+    for (const auto& id : page) {
+        const Review* r = dm.findReview(id);
+        m_rows.append(id);
+        m_keys.append(r ? createdKey(*r) : std::numeric_limits<qint64>::min());
+    }
+    endInsertRows();
+
+    emit countChanged();
+}
+
+void ReviewListModel::reload()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_keys.clear();
+    m_hasMore = false;
+    endResetModel();
+
+    if (!m_serviceId.isNull()) fetchPage();
+    emit countChanged();
+}
+
+// ---------------- DataManager changes ----------------
+int ReviewListModel::insertPosition(qint64 key, const QUuid& id) const
+{
+    int lo = 0;
+    int hi = int(m_rows.size());
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (precedes(m_keys[mid], m_rows[mid], key, id)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+void ReviewListModel::onReviewAdded(const QUuid& id)
+{
+    const Review* r = DataManager::instance().findReview(id);
+    if (!r || m_serviceId.isNull() || r->getServiceId() != m_serviceId) return;
+    const qint64 key = createdKey(*r);
+    const int pos = insertPosition(key, id);
+    if (pos < m_rows.size() && m_rows[pos] == id) return; // уже пришла со страницей
+    // за хвостом загруженного префикса строка придёт со следующей страницей
+    if (pos == m_rows.size() && m_hasMore) {
+        emit countChanged(); // total вырос
+        return;
+    }
+
+    beginInsertRows(QModelIndex(), pos, pos);
+    m_rows.insert(pos, id);
+    m_keys.insert(pos, key);
+    endInsertRows();
+
+    emit countChanged();
+}
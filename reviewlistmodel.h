@@ -0,0 +1,63 @@
+#ifndef REVIEWLISTMODEL_H
+#define REVIEWLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+#include <QUuid>
+
+// Отзывы одной услуги, от новых к старым.
+// Строки читаются из индекса отзывов DataManager страницами (fetchMore),
+// новый отзыв приходит сигналом reviewAdded и вставляется одной строкой.
+class ReviewListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_PROPERTY(QString serviceId READ serviceId WRITE setServiceId NOTIFY serviceIdChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged) // загруженные строки
+    Q_PROPERTY(int total READ total NOTIFY countChanged) // все отзывы услуги
+
+public:
+    // роли совпадают с полями прежнего ListModel reviewModel в main.qml
+    enum Roles {
+        AuthorIdRole = Qt::UserRole + 1,
+        RatingRole,
+        CommentRole,
+        CreatedAtRole
+    };
+
+    explicit ReviewListModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    QString serviceId() const { return m_serviceIdText; }
+    void setServiceId(const QString& id);
+    int count() const { return int(m_rows.size()); }
+    int total() const;
+
+public slots:
+    void reload();
+    void onReviewAdded(const QUuid& id);
+
+signals:
+    void serviceIdChanged();
+    void countChanged();
+
+private:
+    void fetchPage();
+    int insertPosition(qint64 key, const QUuid& id) const;
+
+private:
+    QString m_serviceIdText;
+    QUuid m_serviceId;
+
+    QVector<QUuid> m_rows;
+    QVector<qint64> m_keys; // createdAt, мс — позиция вставки
+    bool m_hasMore = false;
+};
+
+#endif // REVIEWLISTMODEL_H
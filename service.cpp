@@ -47,6 +47,28 @@ Service::Service(const QUuid& id,
     , m_createdAt(QDateTime::currentDateTime())
 {}
 
+Service::Service(const QUuid& id,
+                 const QUuid& providerId,
+                 const QString& title,
+                 const QString& description,
+                 const QString& category,
+                 double price,
+                 bool active,
+                 double rating,
+                 const QDateTime& createdAt,
+                 const QStringList& media)
+    : m_id(id)
+    , m_providerId(providerId)
+    , m_title(title)
+    , m_description(description)
+    , m_category(category)
+    , m_price(price < 0.0 ? 0.0 : price)
+    , m_active(active)
+    , m_rating(clampRating(rating))
+    , m_media(media)
+    , m_createdAt(createdAt)
+{}
+
 // rating
 void Service::setRating(double rating)
 {
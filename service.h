@@ -27,6 +27,18 @@ public:
             bool active,
             double rating);
 
+    // полный набор полей (бинарный снапшот каталога): без createUuid/currentDateTime
+    Service(const QUuid& id,
+            const QUuid& providerId,
+            const QString& title,
+            const QString& description,
+            const QString& category,
+            double price,
+            bool active,
+            double rating,
+            const QDateTime& createdAt,
+            const QStringList& media);
+
     // Getters
     QUuid getId() const { return m_id; }
     QUuid getProviderId() const { return m_providerId; }
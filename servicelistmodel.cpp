@@ -0,0 +1,305 @@
+#include "servicelistmodel.h"
+#include "catalog.h"
+#include "datamanager.h"
+
+static const int kPageSize = 50;
+
+ServiceListModel::ServiceListModel(QObject* parent)
+    : QAbstractListModel(parent),
+      m_catalog(&DataManager::instance().catalog())
+{
+    m_query.sort = CatalogQuery::SortNewest;
+
+    DataManager* dm = &DataManager::instance();
+    connect(dm, &DataManager::servicesReset, this, &ServiceListModel::reload);
+    connect(dm, &DataManager::serviceAdded, this, &ServiceListModel::onServiceAdded);
+    connect(dm, &DataManager::serviceUpdated, this, &ServiceListModel::onServiceUpdated);
+    connect(dm, &DataManager::serviceRemoved, this, &ServiceListModel::onServiceRemoved);
+
+    reload();
+}
+
+int ServiceListModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant ServiceListModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= m_rows.size()) return QVariant();
+
+    const Service* s = m_catalog->findService(m_rows[index.row()]);
+    if (!s) return QVariant();
+
+    switch (role) {
+    case SidRole:          return s->getId().toString(QUuid::WithoutBraces);
+    case ProviderIdRole:   return s->getProviderId().toString(QUuid::WithoutBraces);
+    case Qt::DisplayRole:
+    case TitleRole:        return s->getTitle();
+    case DescriptionRole:  return s->getDescription();
+    case CategoryRole:     return s->getCategory();
+    case PriceRole:        return s->getPrice();
+    case ActiveRole:       return s->isActive();
+    case RatingRole:       return s->getRating();
+    case MediaCsvRole:     return s->getMedia().join(";");
+    case CreatedAtIsoRole: return s->getCreatedAt().toString(Qt::ISODate);
+    default:               return QVariant();
+    }
+}
+
+QHash<int, QByteArray> ServiceListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[SidRole] = "sid";
+    roles[ProviderIdRole] = "providerId";
+    roles[TitleRole] = "title";
+    roles[DescriptionRole] = "description";
+    roles[CategoryRole] = "category";
+    roles[PriceRole] = "price";
+    roles[ActiveRole] = "active";
+    roles[RatingRole] = "rating";
+    roles[MediaCsvRole] = "mediaCsv";
+    roles[CreatedAtIsoRole] = "createdAtIso";
+    return roles;
+}
+
+// ---------------- paging ----------------
+bool ServiceListModel::canFetchMore(const QModelIndex& parent) const
+{
+    return !parent.isValid() && m_hasMore;
+}
+
+void ServiceListModel::fetchMore(const QModelIndex& parent)
+{
+    if (parent.isValid() || !m_hasMore) return;
+    fetchPage();
+}
+
+void ServiceListModel::fetchPage()
+{
+    int pageSize = kPageSize;
+    if (m_maxRows >= 0) pageSize = qMin(pageSize, m_maxRows - int(m_rows.size()));
+    if (pageSize <= 0) {
+        m_hasMore = false;
+        return;
+    }
+
+    CatalogQuery q = m_query;
+    q.limit = pageSize;
+    q.hasAfter = !m_rows.isEmpty();
+    if (q.hasAfter) {
+        q.afterKey = m_keys.last();
+        q.afterId = m_rows.last();
+    }
+
+    const QVector<Service> page = m_catalog->query(q);
+    m_hasMore = (page.size() == pageSize)
+                && (m_maxRows < 0 || m_rows.size() + page.size() < m_maxRows);
+    if (page.isEmpty()) return;
+
+    const int first = int(m_rows.size());
+    beginInsertRows(QModelIndex(), first, first + int(page.size()) - 1);
+    for (const auto& s : page) {
+        const double key = Catalog::sortKey(s, m_query.sort);
+        m_rows.append(s.getId());
+        m_keys.append(key);
+        m_keyOf.insert(s.getId(), key);
+    }
+    endInsertRows();
+
+    emit countChanged();
+}
+
+// top-K: лишняя строка в хвосте уходит, её место займёт следующая по порядку
+void ServiceListModel::trimToLimit()
+{
+    if (m_maxRows < 0 || m_rows.size() <= m_maxRows) return;
+
+    const int first = m_maxRows;
+    const int last = int(m_rows.size()) - 1;
+    beginRemoveRows(QModelIndex(), first, last);
+    for (int i = first; i <= last; ++i)
+        m_keyOf.remove(m_rows[i]);
+    m_rows.resize(m_maxRows);
+    m_keys.resize(m_maxRows);
+    endRemoveRows();
+
+    m_hasMore = true;
+    emit countChanged();
+}
+
+void ServiceListModel::setQuery(const QVariantMap& query)
+{
+    if (query == m_queryMap) return;
+
+    m_queryMap = query;
+    m_query = CatalogQuery::fromVariantMap(query);
+    m_maxRows = m_query.limit;
+    m_query.limit = -1;
+    // загруженные строки — префикс полного порядка, поэтому порядок обязан быть полным
+    if (m_query.sort == CatalogQuery::SortNone) m_query.sort = CatalogQuery::SortNewest;
+
+    reload();
+    emit queryChanged();
+}
+
+void ServiceListModel::reload()
+{
+    beginResetModel();
+    m_rows.clear();
+    m_keys.clear();
+    m_keyOf.clear();
+    m_hasMore = false;
+    endResetModel();
+
+    fetchPage();
+    emit countChanged();
+}
+
+// ---------------- row helpers ----------------
+int ServiceListModel::rowOf(const QUuid& id) const
+{
+    const auto it = m_keyOf.constFind(id);
+    if (it == m_keyOf.constEnd()) return -1;
+
+    const int row = insertPosition(it.value(), id);
+    return (row < m_rows.size() && m_rows[row] == id) ? row : -1;
+}
+
+bool ServiceListModel::precedes(double keyA, const QUuid& idA, double keyB, const QUuid& idB) const
+{
+    // тот же порядок, что у Catalog::query: по ключу, при равенстве по id
+    if (m_query.sort == CatalogQuery::SortPriceAsc) {
+        if (keyA != keyB) return keyA < keyB;
+        return idA < idB;
+    }
+    if (keyA != keyB) return keyA > keyB;
+    return idB < idA;
+}
+
+int ServiceListModel::insertPosition(double key, const QUuid& id) const
+{
+    int lo = 0;
+    int hi = int(m_rows.size());
+    while (lo < hi) {
+        const int mid = (lo + hi) / 2;
+        if (precedes(m_keys[mid], m_rows[mid], key, id)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// ---------------- catalog changes ----------------
+void ServiceListModel::onServiceAdded(const QUuid& id)
+{
+    if (rowOf(id) >= 0) {
+        onServiceUpdated(id);
+        return;
+    }
+
+    const Service* s = m_catalog->findService(id);
+    if (!s || !Catalog::matches(*s, m_query)) return;
+
+    const double key = Catalog::sortKey(*s, m_query.sort);
+    const int pos = insertPosition(key, id);
+    // за хвостом загруженного префикса строка придёт со следующей страницей
+    if (pos == m_rows.size() && m_hasMore) return;
+
+    beginInsertRows(QModelIndex(), pos, pos);
+    m_rows.insert(pos, id);
+    m_keys.insert(pos, key);
+    m_keyOf.insert(id, key);
+    endInsertRows();
+
+    emit countChanged();
+    trimToLimit();
+}
+
+void ServiceListModel::onServiceUpdated(const QUuid& id)
+{
+    const int row = rowOf(id);
+    if (row < 0) {
+        onServiceAdded(id);
+        return;
+    }
+
+    const Service* s = m_catalog->findService(id);
+    if (!s || !Catalog::matches(*s, m_query)) {
+        onServiceRemoved(id);
+        return;
+    }
+
+    const double key = Catalog::sortKey(*s, m_query.sort);
+    const bool afterPrev = (row == 0) || precedes(m_keys[row - 1], m_rows[row - 1], key, id);
+    const bool beforeNext = (row + 1 == m_rows.size()) || precedes(key, id, m_keys[row + 1], m_rows[row + 1]);
+
+    if (afterPrev && beforeNext) {
+        m_keys[row] = key;
+        m_keyOf.insert(id, key);
+        const QModelIndex idx = index(row);
+        emit dataChanged(idx, idx);
+        return;
+    }
+
+    // ключ сортировки сменился — строка переезжает. Строка row ещё со старым ключом,
+    // порядок не нарушен, так что бинарный поиск даёт место в текущей нумерации
+    const int to = insertPosition(key, id);
+    // за хвостом загруженного префикса строка придёт со следующей страницей
+    if (to == m_rows.size() && m_hasMore) {
+        onServiceRemoved(id);
+        return;
+    }
+
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), to);
+    const int dest = to > row ? to - 1 : to;
+    m_rows.removeAt(row);
+    m_keys.removeAt(row);
+    m_rows.insert(dest, id);
+    m_keys.insert(dest, key);
+    m_keyOf.insert(id, key);
+    endMoveRows();
+
+    const QModelIndex idx = index(dest);
+    emit dataChanged(idx, idx);
+}
+
+void ServiceListModel::onServiceRemoved(const QUuid& id)
+{
+    const int row = rowOf(id);
+    if (row < 0) return;
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_rows.removeAt(row);
+    m_keys.removeAt(row);
+    m_keyOf.remove(id);
+    endRemoveRows();
+
+    emit countChanged();
+
+    // у top-K освободилось место: подтягиваем следующую строку
+    if (m_maxRows >= 0 && m_rows.size() < m_maxRows) fetchPage();
+}
+
+// ---------------- QML helpers ----------------
+QString ServiceListModel::idAt(int row) const
+{
+    if (row < 0 || row >= m_rows.size()) return QString();
+    return m_rows[row].toString(QUuid::WithoutBraces);
+}
+
+int ServiceListModel::indexOf(const QString& serviceId) const
+{
+    const QUuid id(serviceId.trimmed());
+    return id.isNull() ? -1 : rowOf(id);
+}
+
+QVariantMap ServiceListModel::get(int row) const
+{
+    QVariantMap out;
+    if (row < 0 || row >= m_rows.size()) return out;
+
+    const QHash<int, QByteArray> roles = roleNames();
+    for (auto it = roles.constBegin(); it != roles.constEnd(); ++it)
+        out[QString::fromUtf8(it.value())] = data(index(row), it.key());
+    return out;
+}
@@ -0,0 +1,87 @@
+#ifndef SERVICELISTMODEL_H
+#define SERVICELISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QVector>
+#include <QUuid>
+#include <QVariantMap>
+
+#include "catalogquery.h"
+
+class Catalog;
+
+// Живой список услуг каталога для QML.
+// Хранит только id строк; поля читаются из Catalog в data() по ролям.
+// Строки подгружаются страницами (fetchMore, keyset-курсор), изменения каталога
+// приходят точечно: rowsInserted / dataChanged / rowsRemoved вместо полного сброса.
+class ServiceListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    // тот же формат, что у DataManager::catalogQuery; limit ограничивает число строк (top-K)
+    Q_PROPERTY(QVariantMap query READ query WRITE setQuery NOTIFY queryChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged) // загруженные строки
+
+public:
+    // роли совпадают с полями ListModel serviceModel в main.qml
+    enum Roles {
+        SidRole = Qt::UserRole + 1,
+        ProviderIdRole,
+        TitleRole,
+        DescriptionRole,
+        CategoryRole,
+        PriceRole,
+        ActiveRole,
+        RatingRole,
+        MediaCsvRole,
+        CreatedAtIsoRole
+    };
+
+    explicit ServiceListModel(QObject* parent = nullptr); // каталог DataManager
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+
+    int count() const { return int(m_rows.size()); }
+
+    QVariantMap query() const { return m_queryMap; }
+    void setQuery(const QVariantMap& query);
+
+    Q_INVOKABLE QString idAt(int row) const;
+    Q_INVOKABLE int indexOf(const QString& serviceId) const;
+    Q_INVOKABLE QVariantMap get(int row) const; // все поля строки (для редактора)
+
+public slots:
+    void reload();
+    void onServiceAdded(const QUuid& id);
+    void onServiceUpdated(const QUuid& id);
+    void onServiceRemoved(const QUuid& id);
+
+signals:
+    void queryChanged();
+    void countChanged();
+
+private:
+    int rowOf(const QUuid& id) const; // O(log n): ключ из m_keyOf + бинарный поиск
+    int insertPosition(double key, const QUuid& id) const;
+    bool precedes(double keyA, const QUuid& idA, double keyB, const QUuid& idB) const;
+    void fetchPage();
+    void trimToLimit();
+
+private:
+    const Catalog* m_catalog;
+    QVariantMap m_queryMap;
+    CatalogQuery m_query;
+    int m_maxRows = -1;       // limit из query; < 0 — все строки
+
+    QVector<QUuid> m_rows;
+    QVector<double> m_keys;   // sortKey строк: позиция вставки и курсор следующей страницы
+    QHash<QUuid, double> m_keyOf; // id -> ключ: без поправки номеров строк при вставке
+    bool m_hasMore = false;
+};
+
+#endif // SERVICELISTMODEL_H
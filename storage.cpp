@@ -0,0 +1,51 @@
+#include "storage.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+// ---------------- paths ----------------
+QString appDataDir()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    return dir;
+}
+
+QString servicesFilePath()       { return appDataDir() + "/services.json"; }
+QString servicesSnapshotFilePath(){ return appDataDir() + "/services.bin"; }
+QString requestsFilePath()       { return appDataDir() + "/requests.json"; }
+QString requestsJournalFilePath(){ return appDataDir() + "/requests.journal"; }
+QString commentsJournalFilePath(){ return appDataDir() + "/comments.journal"; }
+QString reviewsFilePath()        { return appDataDir() + "/reviews.json"; }
+QString subscriptionsFilePath()  { return appDataDir() + "/subscriptions.json"; }
+QString favoritesFilePath()      { return appDataDir() + "/favorites.json"; }
+QString usersFilePath()          { return appDataDir() + "/users.json"; }
+QString usersJournalFilePath()   { return appDataDir() + "/users.journal"; }
+QString conversationsFilePath()  { return appDataDir() + "/conversations.json"; }
+QString conversationsJournalFilePath() { return appDataDir() + "/conversations.journal"; }
+
+QString conversationsDirPath()
+{
+    const QString dir = appDataDir() + "/conversations";
+    QDir().mkpath(dir);
+    return dir;
+}
+
+// ---------------- file helpers ----------------
+QJsonDocument readJsonFile(const QString& path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly)) return QJsonDocument();
+    return QJsonDocument::fromJson(f.readAll());
+}
+
+bool writeJsonFile(const QString& path, const QJsonDocument& doc)
+{
+    QSaveFile f(path);
+    if (!f.open(QIODevice::WriteOnly)) return false;
+
+    f.write(doc.toJson(QJsonDocument::Indented));
+    return f.commit();
+}
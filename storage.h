@@ -0,0 +1,30 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <QString>
+#include <QJsonDocument>
+
+// ---------------- paths ----------------
+QString appDataDir();
+
+QString servicesFilePath();          // JSON: импорт/экспорт и первичная загрузка
+QString servicesSnapshotFilePath();  // бинарный снапшот каталога (CatalogSnapshot)
+QString requestsFilePath();
+QString requestsJournalFilePath();
+QString commentsJournalFilePath();   // старый журнал комментариев: только перенос в беседы
+QString reviewsFilePath();
+QString subscriptionsFilePath();
+QString favoritesFilePath();
+QString usersFilePath();
+QString usersJournalFilePath();
+QString conversationsFilePath();     // метаданные бесед (ConversationStore)
+QString conversationsJournalFilePath();
+QString conversationsDirPath();      // файлы сообщений, по одному на беседу
+
+// ---------------- file helpers ----------------
+QJsonDocument readJsonFile(const QString& path);
+
+// атомарная запись (QSaveFile): на диске либо старый файл, либо новый целиком
+bool writeJsonFile(const QString& path, const QJsonDocument& doc);
+
+#endif // STORAGE_H
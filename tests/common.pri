@@ -0,0 +1,55 @@
+# Общая часть тестов: хранилища приложения без QML и моделей
+QT += testlib concurrent network
+QT -= gui
+
+CONFIG += testcase console
+CONFIG -= app_bundle
+
+SRC = $$PWD/..
+INCLUDEPATH += $$SRC
+
+SOURCES += \
+        $$SRC/catalog.cpp \
+        $$SRC/catalogquery.cpp \
+        $$SRC/catalogsnapshot.cpp \
+        $$SRC/conversationstore.cpp \
+        $$SRC/favorites.cpp \
+        $$SRC/journal.cpp \
+        $$SRC/message.cpp \
+        $$SRC/persistenceworker.cpp \
+        $$SRC/profile.cpp \
+        $$SRC/request.cpp \
+        $$SRC/requestquery.cpp \
+        $$SRC/review.cpp \
+        $$SRC/service.cpp \
+        $$SRC/storage.cpp \
+        $$SRC/subscription.cpp \
+        $$SRC/textindex.cpp \
+        $$SRC/trigramindex.cpp \
+        $$SRC/user.cpp \
+        $$SRC/userdirectory.cpp \
+        $$SRC/userstore.cpp
+
+HEADERS += \
+    $$SRC/catalog.h \
+    $$SRC/catalogquery.h \
+    $$SRC/catalogsnapshot.h \
+    $$SRC/conversationstore.h \
+    $$SRC/favorites.h \
+    $$SRC/idindex.h \
+    $$SRC/journal.h \
+    $$SRC/message.h \
+    $$SRC/persistenceworker.h \
+    $$SRC/profile.h \
+    $$SRC/rankindex.h \
+    $$SRC/request.h \
+    $$SRC/requestquery.h \
+    $$SRC/review.h \
+    $$SRC/service.h \
+    $$SRC/storage.h \
+    $$SRC/subscription.h \
+    $$SRC/textindex.h \
+    $$SRC/trigramindex.h \
+    $$SRC/user.h \
+    $$SRC/userdirectory.h \
+    $$SRC/userstore.h
@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+        tst_catalogquery \
+        tst_catalogsnapshot \
+        tst_conversationstore \
+        tst_journal \
+        tst_persistence
@@ -0,0 +1,115 @@
+#include <QtTest>
+#include <QSet>
+
+#include "catalog.h"
+
+class CatalogQueryTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void pagingAcrossDeletes_data();
+    void pagingAcrossDeletes();
+};
+
+static const int kServices = 120;
+static const int kPage = 7;
+
+// рейтинги и цены с повторами: порядок внутри равных ключей задаёт id
+static Catalog sampleCatalog()
+{
+    Catalog c;
+    const QDateTime base = QDateTime::fromMSecsSinceEpoch(1700000000000);
+    for (int i = 0; i < kServices; ++i) {
+        const QString category = (i % 3 == 0) ? "Ремонт" : "Дизайн";
+        c.addService(Service(QUuid::createUuid(), QUuid::createUuid(), QString("Услуга %1").arg(i), "",
+                             category, double((i * 37) % 11) * 100.0, i % 5 != 0, double(i % 6),
+                             base.addSecs((i * 53) % 17), QStringList()));
+    }
+    return c;
+}
+
+static QVector<QUuid> idsOf(const QVector<Service>& v)
+{
+    QVector<QUuid> ids;
+    for (const auto& s : v)
+        ids.append(s.getId());
+    return ids;
+}
+
+void CatalogQueryTest::pagingAcrossDeletes_data()
+{
+    QTest::addColumn<int>("sort");
+    QTest::addColumn<QString>("category");
+    QTest::addColumn<double>("minPrice");
+
+    QTest::newRow("rating") << int(CatalogQuery::SortRating) << QString() << 0.0;
+    QTest::newRow("newest") << int(CatalogQuery::SortNewest) << QString() << 0.0;
+    QTest::newRow("priceAsc") << int(CatalogQuery::SortPriceAsc) << QString() << 0.0;
+    QTest::newRow("priceDesc") << int(CatalogQuery::SortPriceDesc) << QString() << 0.0;
+    QTest::newRow("rating, category") << int(CatalogQuery::SortRating) << QString("Ремонт") << 0.0;
+    QTest::newRow("newest, price range") << int(CatalogQuery::SortNewest) << QString() << 300.0;
+}
+
+// keyset-курсор (sortKey, id) последней строки: удаления между страницами, в том числе
+// самой строки курсора, не дают ни пропусков, ни повторов среди оставшихся услуг
+void CatalogQueryTest::pagingAcrossDeletes()
+{
+    QFETCH(int, sort);
+    QFETCH(QString, category);
+    QFETCH(double, minPrice);
+
+    Catalog catalog = sampleCatalog();
+
+    CatalogQuery q;
+    q.sort = CatalogQuery::Sort(sort);
+    q.category = category;
+    q.minPrice = minPrice;
+
+    QVector<QUuid> seen;
+    QSet<QUuid> deleted;
+    Service cursor;
+    for (int page = 0; page <= kServices; ++page) {
+        CatalogQuery pq = q;
+        pq.limit = kPage;
+        if (!seen.isEmpty()) {
+            pq.hasAfter = true;
+            pq.afterKey = Catalog::sortKey(cursor, q.sort);
+            pq.afterId = cursor.getId();
+        }
+
+        const QVector<Service> rows = catalog.query(pq);
+        if (rows.isEmpty()) break;
+        QVERIFY(rows.size() <= kPage);
+        for (const auto& s : rows) {
+            QVERIFY2(!seen.contains(s.getId()), "строка повторилась");
+            QVERIFY2(!deleted.contains(s.getId()), "удалённая строка в выдаче");
+            seen.append(s.getId());
+        }
+        cursor = rows.last();
+
+        // между страницами: удаляется строка курсора, а через страницу — и ещё не показанная
+        QVERIFY(catalog.removeService(cursor.getId()));
+        deleted.insert(cursor.getId());
+        if (page % 2 == 0) {
+            const QVector<Service> rest = catalog.query(q);
+            for (const auto& s : rest) {
+                if (seen.contains(s.getId())) continue;
+                QVERIFY(catalog.removeService(s.getId()));
+                deleted.insert(s.getId());
+                break;
+            }
+        }
+    }
+
+    // показанное и не удалённое — ровно оставшаяся выборка и в её порядке
+    QVector<QUuid> shown;
+    for (const auto& id : seen) {
+        if (!deleted.contains(id)) shown.append(id);
+    }
+    QCOMPARE(shown, idsOf(catalog.query(q)));
+    QVERIFY(!seen.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(CatalogQueryTest)
+#include "tst_catalogquery.moc"
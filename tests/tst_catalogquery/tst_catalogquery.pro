@@ -0,0 +1,6 @@
+include(../common.pri)
+
+TARGET = tst_catalogquery
+
+SOURCES += \
+        tst_catalogquery.cpp
@@ -0,0 +1,114 @@
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+
+#include "catalog.h"
+#include "catalogsnapshot.h"
+#include "storage.h"
+
+class CatalogSnapshotTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void roundTrip();
+    void emptyCatalog();
+    void truncatedFileIsRejected();
+
+private:
+    QString m_path;
+};
+
+static Catalog sampleCatalog()
+{
+    Catalog c;
+    const QUuid provider = QUuid::createUuid();
+    const QDateTime at = QDateTime::fromMSecsSinceEpoch(1700000000123);
+
+    c.addService(Service(QUuid::createUuid(), provider, "Ремонт ноутбуков", "Замена экрана, чистка",
+                         "Электроника", 1500.5, true, 4.25, at, QStringList{ "a.png", "b.png" }));
+    c.addService(Service(QUuid::createUuid(), provider, "Уборка", "", "Дом", 0.0, false, 0.0,
+                         at.addDays(1), QStringList{ "a.png" }));
+    // без даты создания и без медиа
+    c.addService(Service(QUuid::createUuid(), QUuid(), "Logo design", "Vector, 3 drafts",
+                         "Электроника", 99.99, true, 5.0, QDateTime(), QStringList()));
+    c.addSearchHistory("ремонт");
+    c.addSearchHistory("logo");
+    return c;
+}
+
+void CatalogSnapshotTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void CatalogSnapshotTest::init()
+{
+    QDir(appDataDir()).removeRecursively();
+    QVERIFY(QDir().mkpath(appDataDir()));
+    m_path = appDataDir() + "/services.bin";
+}
+
+// запись и чтение сохраняют все поля, порядок услуг, категории и историю поиска
+void CatalogSnapshotTest::roundTrip()
+{
+    const Catalog original = sampleCatalog();
+    QVERIFY(CatalogSnapshot::write(CatalogSnapshot::dataOf(original), m_path));
+
+    Catalog restored;
+    QVERIFY(CatalogSnapshot::read(m_path, &restored));
+
+    const QVector<Service> a = original.getAllServices();
+    const QVector<Service> b = restored.getAllServices();
+    QCOMPARE(b.size(), a.size());
+    for (int i = 0; i < a.size(); ++i) {
+        QCOMPARE(b[i].getId(), a[i].getId());
+        QCOMPARE(b[i].getProviderId(), a[i].getProviderId());
+        QCOMPARE(b[i].getTitle(), a[i].getTitle());
+        QCOMPARE(b[i].getDescription(), a[i].getDescription());
+        QCOMPARE(b[i].getCategory(), a[i].getCategory());
+        QCOMPARE(b[i].getPrice(), a[i].getPrice());
+        QCOMPARE(b[i].getRating(), a[i].getRating());
+        QCOMPARE(b[i].isActive(), a[i].isActive());
+        QCOMPARE(b[i].getCreatedAt().isValid(), a[i].getCreatedAt().isValid());
+        if (a[i].getCreatedAt().isValid())
+            QCOMPARE(b[i].getCreatedAt().toMSecsSinceEpoch(), a[i].getCreatedAt().toMSecsSinceEpoch());
+        QCOMPARE(b[i].getMedia(), a[i].getMedia());
+    }
+    QCOMPARE(restored.getCategories(), original.getCategories());
+    QCOMPARE(restored.getSearchHistory(), original.getSearchHistory());
+
+    // индексы собраны при чтении
+    QCOMPARE(restored.searchByName("ноут").size(), 1);
+    QVERIFY(restored.findService(a[2].getId()));
+    QCOMPARE(restored.getNewServices(1).first().getId(), a[1].getId());
+}
+
+void CatalogSnapshotTest::emptyCatalog()
+{
+    QVERIFY(CatalogSnapshot::write(CatalogSnapshot::dataOf(Catalog()), m_path));
+
+    Catalog restored = sampleCatalog();
+    QVERIFY(CatalogSnapshot::read(m_path, &restored));
+    QCOMPARE(restored.serviceCount(), 0);
+}
+
+// оборванный файл не читается, а каталог не меняется
+void CatalogSnapshotTest::truncatedFileIsRejected()
+{
+    QVERIFY(CatalogSnapshot::write(CatalogSnapshot::dataOf(sampleCatalog()), m_path));
+
+    QFile f(m_path);
+    QVERIFY(f.resize(f.size() - 7));
+
+    Catalog restored;
+    QVERIFY(!CatalogSnapshot::read(m_path, &restored));
+    QCOMPARE(restored.serviceCount(), 0);
+}
+
+QTEST_GUILESS_MAIN(CatalogSnapshotTest)
+#include "tst_catalogsnapshot.moc"
@@ -0,0 +1,6 @@
+include(../common.pri)
+
+TARGET = tst_catalogsnapshot
+
+SOURCES += \
+        tst_catalogsnapshot.cpp
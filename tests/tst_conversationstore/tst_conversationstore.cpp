@@ -0,0 +1,67 @@
+#include <QtTest>
+
+#include "conversationstore.h"
+
+class ConversationStoreTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void replaySkipsOpsCoveredBySnapshot();
+    void replayAppliesUnnumberedOps();
+};
+
+static Message newMessage(const QUuid& sender)
+{
+    return Message(QUuid::createUuid(), sender, QUuid(), "hello", QDateTime::currentDateTime());
+}
+
+// снапшот записан, журнал не очищен (сбой между ними): replay не считает сообщения дважды
+void ConversationStoreTest::replaySkipsOpsCoveredBySnapshot()
+{
+    ConversationStore live;
+    const QUuid cid = QUuid::createUuid();
+    const QUuid client = QUuid::createUuid();
+    const QUuid provider = QUuid::createUuid();
+
+    QVector<QJsonObject> journal;
+    live.ensure(cid, QVector<QUuid>{ client, provider });
+    journal.append(live.stamp(ConversationStore::ensureOp(cid, QVector<QUuid>{ client, provider })));
+    for (int i = 0; i < 3; ++i) {
+        const QJsonObject record = live.append(cid, newMessage(client));
+        journal.append(live.stamp(ConversationStore::addOp(cid, record, true)));
+    }
+
+    const QJsonObject snapshot = live.toJson();
+
+    // операция после снапшота
+    const QJsonObject record = live.append(cid, newMessage(provider));
+    journal.append(live.stamp(ConversationStore::addOp(cid, record, true)));
+
+    ConversationStore restored = ConversationStore::fromJson(snapshot);
+    for (const auto& op : journal)
+        restored.applyOp(op);
+
+    QCOMPARE(restored.messageCount(cid), 4);
+    QCOMPARE(restored.unread(cid, provider), 3);
+    QCOMPARE(restored.unread(cid, client), 1);
+}
+
+// журнал старого формата (без seq) применяется целиком
+void ConversationStoreTest::replayAppliesUnnumberedOps()
+{
+    ConversationStore live;
+    const QUuid cid = QUuid::createUuid();
+    const QUuid client = QUuid::createUuid();
+
+    live.ensure(cid, QVector<QUuid>{ client });
+    const QJsonObject record = live.append(cid, newMessage(client));
+
+    ConversationStore restored;
+    restored.applyOp(ConversationStore::ensureOp(cid, QVector<QUuid>{ client }));
+    restored.applyOp(ConversationStore::addOp(cid, record, true));
+    QCOMPARE(restored.messageCount(cid), 1);
+}
+
+QTEST_GUILESS_MAIN(ConversationStoreTest)
+#include "tst_conversationstore.moc"
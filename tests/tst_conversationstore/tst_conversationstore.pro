@@ -0,0 +1,6 @@
+include(../common.pri)
+
+TARGET = tst_conversationstore
+
+SOURCES += \
+        tst_conversationstore.cpp
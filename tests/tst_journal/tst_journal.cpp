@@ -0,0 +1,117 @@
+#include <QtTest>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+#include "journal.h"
+#include "storage.h"
+
+class JournalTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void replaySkipsTornTail();
+    void appendAfterFailedAppend();
+    void readBeforeCrossesChunks();
+    void rewriteReplacesRecords();
+
+private:
+    QString m_path;
+};
+
+static QJsonObject record(int n)
+{
+    QJsonObject o;
+    o["n"] = n;
+    o["pad"] = QString(100, QLatin1Char('x')); // записи длиннее, чтобы журнал занимал несколько блоков чтения
+    return o;
+}
+
+void JournalTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void JournalTest::init()
+{
+    QDir(appDataDir()).removeRecursively();
+    QVERIFY(QDir().mkpath(appDataDir()));
+    m_path = appDataDir() + "/test.journal";
+}
+
+// сбой посреди записи: оборванная строка в конце пропускается, целые читаются
+void JournalTest::replaySkipsTornTail()
+{
+    Journal j(m_path);
+    QVERIFY(j.append(QVector<QJsonObject>{ record(1), record(2) }));
+
+    QFile f(m_path);
+    QVERIFY(f.open(QIODevice::Append));
+    f.write("{\"n\":3,\"pad\":\"xx");
+    f.close();
+
+    const QVector<QJsonObject> ops = Journal::readRecords(m_path);
+    QCOMPARE(ops.size(), 2);
+    QCOMPARE(ops[0].value("n").toInt(), 1);
+    QCOMPARE(ops[1].value("n").toInt(), 2);
+}
+
+// неудачная дозапись ничего не оставляет; повтор дописывает те же записи по порядку
+void JournalTest::appendAfterFailedAppend()
+{
+    Journal j(m_path);
+    QVERIFY(QDir().mkpath(m_path));
+    QVERIFY(!j.append(QVector<QJsonObject>{ record(1), record(2) }));
+    QVERIFY(QDir().rmdir(m_path));
+
+    QVERIFY(j.append(QVector<QJsonObject>{ record(1), record(2) }));
+    QVERIFY(j.append(record(3)));
+
+    const QVector<QJsonObject> ops = Journal::readRecords(m_path);
+    QCOMPARE(ops.size(), 3);
+    for (int i = 0; i < ops.size(); ++i)
+        QCOMPARE(ops[i].value("n").toInt(), i + 1);
+}
+
+// чтение с конца блоками: страницы подряд собирают весь журнал без пропусков и повторов
+void JournalTest::readBeforeCrossesChunks()
+{
+    const int total = 2000; // ~250 КБ: несколько блоков по 64 КБ
+    QVector<QJsonObject> records;
+    for (int i = 0; i < total; ++i)
+        records.append(record(i));
+    QVERIFY(Journal(m_path).append(records));
+
+    qint64 end = QFileInfo(m_path).size();
+    int expected = total - 1;
+    while (end > 0) {
+        const QVector<Journal::Record> page = Journal::readRecordsBefore(m_path, end, 300);
+        QVERIFY(!page.isEmpty());
+        for (int i = int(page.size()) - 1; i >= 0; --i)
+            QCOMPARE(page[i].object.value("n").toInt(), expected--);
+        end = page.first().offset;
+    }
+    QCOMPARE(expected, -1);
+}
+
+void JournalTest::rewriteReplacesRecords()
+{
+    Journal j(m_path);
+    QVERIFY(j.append(QVector<QJsonObject>{ record(1), record(2), record(3) }));
+    QVERIFY(j.rewrite(QVector<QJsonObject>{ record(3) }));
+
+    const QVector<QJsonObject> ops = Journal::readRecords(m_path);
+    QCOMPARE(ops.size(), 1);
+    QCOMPARE(ops[0].value("n").toInt(), 3);
+
+    QVERIFY(j.clear());
+    QVERIFY(Journal::readRecords(m_path).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(JournalTest)
+#include "tst_journal.moc"
@@ -0,0 +1,6 @@
+include(../common.pri)
+
+TARGET = tst_journal
+
+SOURCES += \
+        tst_journal.cpp
@@ -0,0 +1,155 @@
+#include <QtTest>
+#include <QDir>
+#include <QSet>
+#include <QStandardPaths>
+
+#include "persistenceworker.h"
+#include "storage.h"
+#include "journal.h"
+#include "conversationstore.h"
+
+// Сбои записи моделируются каталогом на месте файла: QSaveFile не заменит
+// каталог, а QFile не откроет его на дозапись.
+class PersistenceWorkerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void snapshotFailureKeepsJournalOps();
+    void journalFailureRequeuesOps();
+    void retireCommentsWaitsForMessages();
+};
+
+static QJsonObject createOp(const Request& r)
+{
+    QJsonObject op;
+    op["op"] = "create";
+    op["id"] = r.getId().toString(QUuid::WithoutBraces);
+    op["request"] = r.toJson();
+    return op;
+}
+
+static Request newRequest()
+{
+    return Request(QUuid::createUuid(), QUuid::createUuid(), QUuid::createUuid(), QUuid::createUuid());
+}
+
+// id заявок так, как их восстановит загрузка: requests.json + requests.journal
+static QSet<QUuid> storedRequestIds()
+{
+    QSet<QUuid> ids;
+    const QJsonArray arr = readJsonFile(requestsFilePath()).array();
+    for (const auto& v : arr)
+        ids.insert(Request::fromJson(v.toObject()).getId());
+
+    const QVector<QJsonObject> ops = Journal::readRecords(requestsJournalFilePath());
+    for (const auto& op : ops) {
+        const QUuid id(op.value("id").toString());
+        if (op.value("op").toString() == "create") ids.insert(id);
+        else if (op.value("op").toString() == "delete") ids.remove(id);
+    }
+    return ids;
+}
+
+void PersistenceWorkerTest::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+}
+
+void PersistenceWorkerTest::init()
+{
+    QDir(appDataDir()).removeRecursively();
+    QVERIFY(QDir().mkpath(appDataDir()));
+}
+
+// снапшот не записался, журнал дописан: снапшот отбрасывается, а не ждёт повтора,
+// иначе его запись очистила бы журнал вместе с операцией b
+void PersistenceWorkerTest::snapshotFailureKeepsJournalOps()
+{
+    PersistenceWorker w;
+    const Request a = newRequest();
+    const Request b = newRequest();
+
+    w.appendRequestOp(createOp(a));
+    w.submitRequests(QVector<Request>{ a });
+    w.appendRequestOp(createOp(b));
+
+    QVERIFY(QDir().mkpath(requestsFilePath()));
+    w.flush();
+    QVERIFY(QDir().rmdir(requestsFilePath()));
+
+    const QSet<QUuid> both{ a.getId(), b.getId() };
+    QCOMPARE(storedRequestIds(), both);
+    QCOMPARE(Journal::readRecords(requestsJournalFilePath()).size(), 2);
+
+    // повтор: в очереди ничего не осталось, журнал не тронут
+    w.flush();
+    QVERIFY(!QFile::exists(requestsFilePath()));
+    QCOMPARE(storedRequestIds(), both);
+
+    // следующий checkpoint сворачивает журнал
+    w.submitRequests(QVector<Request>{ a, b });
+    w.flush();
+    QCOMPARE(storedRequestIds(), both);
+    QVERIFY(Journal::readRecords(requestsJournalFilePath()).isEmpty());
+}
+
+// журнал не дописался: операции возвращаются в очередь и уходят со следующей записью
+void PersistenceWorkerTest::journalFailureRequeuesOps()
+{
+    PersistenceWorker w;
+    const Request a = newRequest();
+    const Request b = newRequest();
+
+    QVERIFY(QDir().mkpath(requestsJournalFilePath()));
+    w.appendRequestOp(createOp(a));
+    w.flush();
+    QVERIFY(QDir().rmdir(requestsJournalFilePath()));
+    QVERIFY(storedRequestIds().isEmpty());
+
+    w.appendRequestOp(createOp(b));
+    w.flush();
+
+    const QVector<QJsonObject> ops = Journal::readRecords(requestsJournalFilePath());
+    QCOMPARE(ops.size(), 2);
+    QCOMPARE(QUuid(ops[0].value("id").toString()), a.getId()); // порядок операций сохранён
+    QCOMPARE(QUuid(ops[1].value("id").toString()), b.getId());
+}
+
+// перенос комментариев в беседы: comments.journal удаляется и снапшот заявок
+// (уже без комментариев внутри) пишется, только когда строки бесед на диске
+void PersistenceWorkerTest::retireCommentsWaitsForMessages()
+{
+    PersistenceWorker w;
+    const Request r = newRequest();
+    const QString conversation = ConversationStore::filePath(conversationsDirPath(), r.getId());
+    const Message m(QUuid::createUuid(), QUuid(), QUuid(), "legacy", QDateTime::currentDateTime());
+
+    QVERIFY(Journal(commentsJournalFilePath()).append(QJsonObject{ { "op", "add" } }));
+    w.appendMessage(conversation, m.toJson());
+    w.retireComments();
+    w.submitRequests(QVector<Request>{ r });
+
+    QVERIFY(QDir().mkpath(conversation));
+    w.flush();
+    QVERIFY(QDir().rmdir(conversation));
+    QVERIFY(QFile::exists(commentsJournalFilePath()));
+    QVERIFY(!QFile::exists(requestsFilePath()));
+
+    w.flush();
+    const QVector<QJsonObject> records = Journal::readRecords(conversation);
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(QUuid(records[0].value("id").toString()), m.getId());
+    QVERIFY(!QFile::exists(commentsJournalFilePath()));
+
+    // снапшот заявок был отброшен вместе с первой попыткой — его сделает следующий checkpoint
+    w.submitRequests(QVector<Request>{ r });
+    w.flush();
+    QVERIFY(QFile::exists(requestsFilePath()));
+}
+
+QTEST_GUILESS_MAIN(PersistenceWorkerTest)
+#include "tst_persistence.moc"
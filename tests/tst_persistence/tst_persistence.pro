@@ -0,0 +1,6 @@
+include(../common.pri)
+
+TARGET = tst_persistence
+
+SOURCES += \
+        tst_persistence.cpp
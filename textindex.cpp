@@ -0,0 +1,73 @@
+#include "textindex.h"
+
+#include <QVector>
+
+QString TextIndex::fold(const QString& s)
+{
+    QString f = s.toCaseFolded();
+    f.replace(QChar(0x0451), QChar(0x0435)); // ё -> е
+    return f;
+}
+
+QStringList TextIndex::tokenize(const QString& s)
+{
+    QStringList out;
+    const QString f = fold(s);
+
+    QString cur;
+    for (const QChar c : f) {
+        if (c.isLetterOrNumber()) {
+            cur.append(c);
+        } else if (!cur.isEmpty()) {
+            out.append(cur);
+            cur.clear();
+        }
+    }
+    if (!cur.isEmpty()) out.append(cur);
+
+    out.removeDuplicates();
+    return out;
+}
+
+void TextIndex::add(const QUuid& id, const QString& text)
+{
+    const QStringList terms = tokenize(text);
+    for (const auto& t : terms)
+        m_postings[t].insert(id);
+}
+
+void TextIndex::remove(const QUuid& id, const QString& text)
+{
+    const QStringList terms = tokenize(text);
+    for (const auto& t : terms) {
+        auto it = m_postings.find(t);
+        if (it == m_postings.end()) continue;
+
+        it.value().remove(id);
+        if (it.value().isEmpty()) m_postings.erase(it);
+    }
+}
+
+QSet<QUuid> TextIndex::match(const QString& query) const
+{
+    const QStringList terms = tokenize(query);
+    if (terms.isEmpty()) return QSet<QUuid>();
+
+    // собираем posting lists; начинаем пересечение с самого короткого
+    QVector<const QSet<QUuid>*> lists;
+    for (const auto& t : terms) {
+        const auto it = m_postings.constFind(t);
+        if (it == m_postings.constEnd()) return QSet<QUuid>();
+        lists.append(&it.value());
+    }
+
+    int smallest = 0;
+    for (int i = 1; i < lists.size(); ++i)
+        if (lists[i]->size() < lists[smallest]->size()) smallest = i;
+
+    QSet<QUuid> result = *lists[smallest];
+    for (int i = 0; i < lists.size() && !result.isEmpty(); ++i)
+        if (i != smallest) result.intersect(*lists[i]);
+
+    return result;
+}
@@ -0,0 +1,31 @@
+#ifndef TEXTINDEX_H
+#define TEXTINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QUuid>
+
+// Инвертированный индекс по словам: терм -> множество id.
+// Термы — свёрнутые по регистру (toCaseFolded, латиница и кириллица, ё == е)
+// последовательности букв/цифр. Обновляется инкрементально: add/remove
+// должны получать тот же текст, что был проиндексирован.
+class TextIndex
+{
+public:
+    static QString fold(const QString& s);
+    static QStringList tokenize(const QString& s); // уникальные термы
+
+    void add(const QUuid& id, const QString& text);
+    void remove(const QUuid& id, const QString& text);
+    void clear() { m_postings.clear(); }
+
+    // AND: id, в тексте которых есть все термы запроса; пустой запрос -> пусто
+    QSet<QUuid> match(const QString& query) const;
+
+private:
+    QHash<QString, QSet<QUuid>> m_postings;
+};
+
+#endif // TEXTINDEX_H
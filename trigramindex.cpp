@@ -0,0 +1,69 @@
+#include "trigramindex.h"
+
+// три UTF-16 символа упаковываются в один ключ
+static quint64 packTrigram(const QChar* p)
+{
+    return (quint64(p[0].unicode()) << 32) | (quint64(p[1].unicode()) << 16) | quint64(p[2].unicode());
+}
+
+QVector<quint64> TrigramIndex::trigrams(const QString& text)
+{
+    QVector<quint64> out;
+    const QString f = text.toCaseFolded();
+    if (f.size() < 3) return out;
+
+    QSet<quint64> seen;
+    const QChar* p = f.constData();
+    for (int i = 0; i + 3 <= f.size(); ++i) {
+        const quint64 t = packTrigram(p + i);
+        if (seen.contains(t)) continue;
+        seen.insert(t);
+        out.append(t);
+    }
+    return out;
+}
+
+void TrigramIndex::add(const QUuid& id, const QString& text)
+{
+    const QVector<quint64> ts = trigrams(text);
+    for (quint64 t : ts)
+        m_postings[t].insert(id);
+}
+
+void TrigramIndex::remove(const QUuid& id, const QString& text)
+{
+    const QVector<quint64> ts = trigrams(text);
+    for (quint64 t : ts) {
+        auto it = m_postings.find(t);
+        if (it == m_postings.end()) continue;
+
+        it.value().remove(id);
+        if (it.value().isEmpty()) m_postings.erase(it);
+    }
+}
+
+bool TrigramIndex::candidates(const QString& fragment, QSet<QUuid>* out) const
+{
+    if (!out) return false;
+    out->clear();
+
+    const QVector<quint64> ts = trigrams(fragment);
+    if (ts.isEmpty()) return false;
+
+    QVector<const QSet<QUuid>*> lists;
+    for (quint64 t : ts) {
+        const auto it = m_postings.constFind(t);
+        if (it == m_postings.constEnd()) return true; // триграммы нет ни у кого -> пусто
+        lists.append(&it.value());
+    }
+
+    int smallest = 0;
+    for (int i = 1; i < lists.size(); ++i)
+        if (lists[i]->size() < lists[smallest]->size()) smallest = i;
+
+    *out = *lists[smallest];
+    for (int i = 0; i < lists.size() && !out->isEmpty(); ++i)
+        if (i != smallest) out->intersect(*lists[i]);
+
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QUuid>
+#include <QVector>
+
+// Индекс триграмм (по 3 символа свёрнутого по регистру текста) -> множество id.
+// Даёт кандидатов для поиска подстроки: если текст содержит фрагмент,
+// то содержит и все его триграммы. Кандидатов нужно проверять точно (contains).
+class TrigramIndex
+{
+public:
+    void add(const QUuid& id, const QString& text);
+    void remove(const QUuid& id, const QString& text);
+    void clear() { m_postings.clear(); }
+
+    // false — фрагмент короче триграммы, индекс не помогает (нужен полный проход)
+    bool candidates(const QString& fragment, QSet<QUuid>* out) const;
+
+private:
+    static QVector<quint64> trigrams(const QString& text); // уникальные
+
+    QHash<quint64, QSet<QUuid>> m_postings;
+};
+
+#endif // TRIGRAMINDEX_H
@@ -1,13 +1,27 @@
 #include "user.h"
 
 #include <QCryptographicHash>
+#include <QPasswordDigestor>
 #include <QRandomGenerator>
+#include <QElapsedTimer>
+#include <QAtomicInt>
 #include <QDateTime>
+#include <limits>
+
+// границы стоимости KDF: ниже — слишком дёшево для перебора, выше — логин в секундах
+static const int kMinIterations = 10000;
+static const int kMaxIterations = 5000000;
+static const int kProbeIterations = 20000;
+static const int kProbeRuns = 3;
+static const int kKeyLength = 32;
+
+static QAtomicInt g_defaultIterations(100000);
 
 User::User()
     : id(QUuid::createUuid())
     , role(Client)
     , verified(false)
+    , passwordIterations(0)
 {
 }
 
@@ -53,13 +67,56 @@ QString User::hashPassword(const QString& saltHex, const QString& password)
     return sha256Hex((saltHex + ":" + password).toUtf8());
 }
 
+QString User::pbkdf2Hex(const QString& saltHex, const QString& password, int iterations)
+{
+    const QByteArray key = QPasswordDigestor::deriveKeyPbkdf2(QCryptographicHash::Sha256,
+                                                              password.toUtf8(),
+                                                              QByteArray::fromHex(saltHex.toLatin1()),
+                                                              iterations, kKeyLength);
+    return QString(key.toHex());
+}
+
+int User::defaultIterations()
+{
+    return g_defaultIterations.loadRelaxed();
+}
+
+void User::setDefaultIterations(int iterations)
+{
+    g_defaultIterations.storeRelaxed(qBound(kMinIterations, iterations, kMaxIterations));
+}
+
+int User::calibrateIterations(int targetMs)
+{
+    // лучший из нескольких прогонов: помехи (другие потоки, прогрев) только замедляют
+    qint64 elapsed = std::numeric_limits<qint64>::max();
+    for (int i = 0; i < kProbeRuns; ++i) {
+        QElapsedTimer t;
+        t.start();
+        pbkdf2Hex(makeSaltHex(), "calibration", kProbeIterations);
+        elapsed = qMin(elapsed, t.nsecsElapsed() / 1000000);
+    }
+    elapsed = qMax<qint64>(1, elapsed);
+
+    const qint64 iterations = qint64(kProbeIterations) * targetMs / elapsed;
+    return int(qBound<qint64>(kMinIterations, iterations, kMaxIterations));
+}
+
+// гистерезис: замер на каждом запуске шумит, поэтому перехеширование — только если
+// стоимость вдвое ниже текущей (или ниже минимума), а не на каждом колебании
+bool User::needsRehash() const
+{
+    return passwordIterations < kMinIterations || qint64(passwordIterations) * 2 < defaultIterations();
+}
+
 bool User::setPassword(const QString& plainPassword)
 {
     if (plainPassword.length() < 6)
         return false;
 
     passwordSalt = makeSaltHex();
-    passwordHash = hashPassword(passwordSalt, plainPassword);
+    passwordIterations = defaultIterations();
+    passwordHash = pbkdf2Hex(passwordSalt, plainPassword, passwordIterations);
     return true;
 }
 
@@ -67,7 +124,10 @@ bool User::checkPassword(const QString& plainPassword) const
 {
     if (passwordSalt.isEmpty() || passwordHash.isEmpty())
         return false;
-    return hashPassword(passwordSalt, plainPassword) == passwordHash;
+
+    if (passwordIterations <= 0)
+        return hashPassword(passwordSalt, plainPassword) == passwordHash;
+    return pbkdf2Hex(passwordSalt, plainPassword, passwordIterations) == passwordHash;
 }
 
 // -------- verification --------
@@ -119,6 +179,7 @@ QJsonObject User::toJson() const
     o["verified"] = verified;
     o["salt"] = passwordSalt;
     o["passwordHash"] = passwordHash;
+    o["iterations"] = passwordIterations;
     o["verificationCodeHash"] = verificationCodeHash;
     return o;
 }
@@ -143,6 +204,7 @@ User User::fromJson(const QJsonObject& obj, bool* ok)
 
     u.passwordSalt = obj.value("salt").toString();
     u.passwordHash = obj.value("passwordHash").toString();
+    u.passwordIterations = obj.value("iterations").toInt(0);
     u.verificationCodeHash = obj.value("verificationCodeHash").toString();
 
     if (ok) *ok = true;
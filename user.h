@@ -24,6 +24,7 @@ public:
 
     QString passwordSalt;
     QString passwordHash;
+    int passwordIterations;   // PBKDF2-SHA256; 0 — старый формат sha256(salt:password)
     QString verificationCodeHash;
 
     // business
@@ -31,8 +32,16 @@ public:
     static QString roleToString(Role r);
     static Role roleFromInt(int v);
 
+    // setPassword/checkPassword стоят сотни миллисекунд: вызывать из пула потоков
     bool setPassword(const QString& plainPassword);
     bool checkPassword(const QString& plainPassword) const;
+    bool needsRehash() const; // старый формат или стоимость заметно ниже текущей
+
+    // стоимость KDF для новых паролей; общая для всех потоков
+    static int defaultIterations();
+    static void setDefaultIterations(int iterations);
+    // замер PBKDF2 на этой машине: число итераций, дающее ~targetMs на один хеш
+    static int calibrateIterations(int targetMs);
 
     QString issueVerificationCode();          // возвращает код (для демо)
     bool verifyAccount(const QString& code);  // применяет к текущему объекту
@@ -46,7 +55,8 @@ public:
 private:
     static QString sha256Hex(const QByteArray& data);
     static QString makeSaltHex();
-    static QString hashPassword(const QString& saltHex, const QString& password);
+    static QString hashPassword(const QString& saltHex, const QString& password); // старый формат
+    static QString pbkdf2Hex(const QString& saltHex, const QString& password, int iterations);
 };
 
 #endif // USER_H
@@ -0,0 +1,63 @@
+#include "userdirectory.h"
+
+QString UserDirectory::emailKey(const QString& email)
+{
+    return email.trimmed().toCaseFolded();
+}
+
+QString UserDirectory::phoneKey(const QString& phone)
+{
+    // "+7 (900) 123-45-67" и "+79001234567" — один номер
+    const QString t = phone.trimmed();
+
+    QString out;
+    out.reserve(t.size());
+    if (t.startsWith('+')) out.append('+');
+    for (const QChar c : t) {
+        if (c.isDigit()) out.append(c);
+    }
+    return out == "+" ? QString() : out;
+}
+
+void UserDirectory::clear()
+{
+    m_byEmail.clear();
+    m_byPhone.clear();
+}
+
+void UserDirectory::insert(const QString& email, const QString& phone, int slot)
+{
+    const QString em = emailKey(email);
+    if (!em.isEmpty()) m_byEmail.insert(em, slot);
+
+    const QString ph = phoneKey(phone);
+    if (!ph.isEmpty()) m_byPhone.insert(ph, slot);
+}
+
+void UserDirectory::remove(const QString& email, const QString& phone)
+{
+    m_byEmail.remove(emailKey(email));
+    m_byPhone.remove(phoneKey(phone));
+}
+
+int UserDirectory::slotOfEmail(const QString& email) const
+{
+    const QString em = emailKey(email);
+    return em.isEmpty() ? -1 : m_byEmail.value(em, -1);
+}
+
+int UserDirectory::slotOfPhone(const QString& phone) const
+{
+    const QString ph = phoneKey(phone);
+    return ph.isEmpty() ? -1 : m_byPhone.value(ph, -1);
+}
+
+int UserDirectory::slotOf(const QString& emailOrPhone) const
+{
+    const int idx = slotOfEmail(emailOrPhone);
+    if (idx >= 0) return idx;
+
+    // цифры из email ("user123@mail.ru") телефоном не считаются
+    if (emailOrPhone.contains('@')) return -1;
+    return slotOfPhone(emailOrPhone);
+}
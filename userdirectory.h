@@ -0,0 +1,29 @@
+#ifndef USERDIRECTORY_H
+#define USERDIRECTORY_H
+
+#include <QHash>
+#include <QString>
+
+// Хеш-индексы пользователей для логина и проверки дублей при регистрации:
+// свёрнутый email -> slot и нормализованный телефон -> slot.
+// slot — позиция записи в QVector хранилища (как у IdIndex).
+class UserDirectory
+{
+public:
+    static QString emailKey(const QString& email); // trimmed + toCaseFolded
+    static QString phoneKey(const QString& phone); // только цифры, ведущий '+' сохраняется
+
+    void clear();
+    void insert(const QString& email, const QString& phone, int slot);
+    void remove(const QString& email, const QString& phone);
+
+    int slotOfEmail(const QString& email) const;
+    int slotOfPhone(const QString& phone) const;   // пустой телефон не ищется
+    int slotOf(const QString& emailOrPhone) const; // сначала email, затем телефон
+
+private:
+    QHash<QString, int> m_byEmail;
+    QHash<QString, int> m_byPhone;
+};
+
+#endif // USERDIRECTORY_H
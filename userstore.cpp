@@ -0,0 +1,141 @@
+#include "userstore.h"
+
+#include <QJsonArray>
+
+// ключи для IdIndex
+static QUuid userKey(const User& u) { return u.id; }
+static QUuid profileOwnerKey(const Profile& p) { return p.ownerUserId(); }
+
+// ---------------- users ----------------
+const User* UserStore::findUser(const QUuid& id) const
+{
+    const int idx = m_userIndex.slotOf(id);
+    return idx >= 0 ? &m_users[idx] : nullptr;
+}
+
+const User* UserStore::findByEmail(const QString& email) const
+{
+    const int idx = m_directory.slotOfEmail(email);
+    return idx >= 0 ? &m_users[idx] : nullptr;
+}
+
+const User* UserStore::findByPhone(const QString& phone) const
+{
+    const int idx = m_directory.slotOfPhone(phone);
+    return idx >= 0 ? &m_users[idx] : nullptr;
+}
+
+const User* UserStore::findByLogin(const QString& emailOrPhone) const
+{
+    const int idx = m_directory.slotOf(emailOrPhone);
+    return idx >= 0 ? &m_users[idx] : nullptr;
+}
+
+void UserStore::putUser(const User& user)
+{
+    if (user.id.isNull()) return;
+
+    const int idx = m_userIndex.slotOf(user.id);
+    if (idx < 0) {
+        const int slot = m_userIndex.append(m_users, user, userKey);
+        m_directory.insert(user.email, user.phone, slot);
+        return;
+    }
+
+    m_directory.remove(m_users[idx].email, m_users[idx].phone);
+    m_users[idx] = user;
+    m_directory.insert(user.email, user.phone, idx);
+}
+
+// ---------------- profiles ----------------
+const Profile* UserStore::findProfile(const QUuid& ownerUserId) const
+{
+    const int idx = m_profileIndex.slotOf(ownerUserId);
+    return idx >= 0 ? &m_profiles[idx] : nullptr;
+}
+
+void UserStore::putProfile(const Profile& profile)
+{
+    if (profile.ownerUserId().isNull()) return;
+
+    const int idx = m_profileIndex.slotOf(profile.ownerUserId());
+    if (idx >= 0) m_profiles[idx] = profile;
+    else m_profileIndex.append(m_profiles, profile, profileOwnerKey);
+}
+
+// ---------------- persistence ----------------
+QJsonObject UserStore::toJson() const
+{
+    QJsonArray users;
+    for (const auto& u : m_users)
+        users.append(u.toJson());
+
+    QJsonArray profiles;
+    for (const auto& p : m_profiles)
+        profiles.append(p.toJson());
+
+    QJsonObject o;
+    o["users"] = users;
+    o["profiles"] = profiles;
+    return o;
+}
+
+UserStore UserStore::fromJson(const QJsonObject& obj)
+{
+    UserStore s;
+
+    const QJsonArray users = obj.value("users").toArray();
+    s.m_users.reserve(users.size());
+    for (const auto& v : users) {
+        bool ok = false;
+        const User u = User::fromJson(v.toObject(), &ok);
+        if (ok) s.m_users.append(u);
+    }
+
+    const QJsonArray profiles = obj.value("profiles").toArray();
+    s.m_profiles.reserve(profiles.size());
+    for (const auto& v : profiles)
+        s.m_profiles.append(Profile::fromJson(v.toObject()));
+
+    s.rebuildIndexes();
+    return s;
+}
+
+void UserStore::rebuildIndexes()
+{
+    m_userIndex.rebuild(m_users, userKey);
+    m_directory.clear();
+    for (int i = 0; i < m_users.size(); ++i)
+        m_directory.insert(m_users[i].email, m_users[i].phone, i);
+
+    m_profileIndex.rebuild(m_profiles, profileOwnerKey);
+}
+
+QJsonObject UserStore::userOp(const User& user)
+{
+    QJsonObject o;
+    o["op"] = "user";
+    o["user"] = user.toJson();
+    return o;
+}
+
+QJsonObject UserStore::profileOp(const Profile& profile)
+{
+    QJsonObject o;
+    o["op"] = "profile";
+    o["profile"] = profile.toJson();
+    return o;
+}
+
+void UserStore::applyOp(const QJsonObject& op)
+{
+    const QString kind = op.value("op").toString();
+
+    if (kind == "user") {
+        bool ok = false;
+        const User u = User::fromJson(op.value("user").toObject(), &ok);
+        if (ok) putUser(u);
+    } else if (kind == "profile") {
+        putProfile(Profile::fromJson(op.value("profile").toObject()));
+    }
+}
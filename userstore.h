@@ -0,0 +1,52 @@
+#ifndef USERSTORE_H
+#define USERSTORE_H
+
+#include <QVector>
+#include <QJsonObject>
+
+#include "user.h"
+#include "profile.h"
+#include "idindex.h"
+#include "userdirectory.h"
+
+// Пользователи и их профили с индексами: id, email, телефон (UserDirectory),
+// владелец профиля. Хранится как users.json (снапшот) + users.journal
+// (upsert-операции); копия — O(1), её и отдают PersistenceWorker.
+class UserStore
+{
+public:
+    int userCount() const { return int(m_users.size()); }
+    int profileCount() const { return int(m_profiles.size()); }
+
+    const User* findUser(const QUuid& id) const;
+    const User* findByEmail(const QString& email) const;
+    const User* findByPhone(const QString& phone) const;
+    const User* findByLogin(const QString& emailOrPhone) const;
+
+    // вставка или замена по id; индексы email/телефона следуют за изменениями
+    void putUser(const User& user);
+
+    const Profile* findProfile(const QUuid& ownerUserId) const;
+    void putProfile(const Profile& profile); // по ownerUserId
+
+    // ---- persistence ----
+    QJsonObject toJson() const; // {users: [...], profiles: [...]}
+    static UserStore fromJson(const QJsonObject& obj);
+
+    static QJsonObject userOp(const User& user);
+    static QJsonObject profileOp(const Profile& profile);
+    void applyOp(const QJsonObject& op);
+
+private:
+    void rebuildIndexes();
+
+private:
+    QVector<User> m_users;
+    IdIndex m_userIndex;            // id -> slot
+    UserDirectory m_directory;      // email / phone -> slot
+
+    QVector<Profile> m_profiles;
+    IdIndex m_profileIndex;         // ownerUserId -> slot
+};
+
+#endif // USERSTORE_H